@@ -0,0 +1,44 @@
+#ifndef MINISTL_BENCH_H
+#define MINISTL_BENCH_H
+
+// Helpers shared by the standalone benchmark programs of this directory.
+// Every program has a main of its own and is built on its own, e.g.
+//   g++ -std=c++11 -O2 -I../src sort_bench.cc -o sort_bench
+
+#include <chrono>
+#include <cstdio>
+
+namespace ministl {
+namespace bench {
+
+inline double now( )
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now( ).time_since_epoch( )).count( );
+}
+
+// the best time of repeats runs of f, in seconds
+template <typename F>
+double best_time(int repeats, F f)
+{
+  double best = 1e30;
+  for (int i = 0; i < repeats; ++i) {
+    const double start = now( );
+    f( );
+    const double elapsed = now( ) - start;
+    if (elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// keep the compiler from dropping the computation of x
+template <typename T>
+inline void keep(const T& x)
+{
+  asm volatile("" : : "r"(&x) : "memory");
+}
+
+} // namespace bench
+} // namespace ministl
+
+#endif // MINISTL_BENCH_H
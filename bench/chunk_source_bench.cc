@@ -0,0 +1,122 @@
+// Random access into a large vector whose storage comes from malloc or from
+// huge_page_chunk_source. The elements form one random cycle which is
+// followed from element to element, so every access depends on the last one
+// and most of them miss the TLB when the vector lives on 4 KiB pages. The
+// dTLB misses are read from perf_event_open on Linux, when it is allowed.
+//
+//   g++ -std=c++11 -O2 -I../src chunk_source_bench.cc -o chunk_source_bench
+//   ./chunk_source_bench [MiB]
+
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include "bench.h"
+#include "alloc.h"
+#include "vector.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ministl {
+namespace bench {
+
+// counts the dTLB load misses of the calling thread, or nothing at all
+class tlb_counter {
+public:
+  tlb_counter( ) : fd(-1)
+  {
+#ifdef __linux__
+    perf_event_attr attr = perf_event_attr( );
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~tlb_counter( )
+  {
+#ifdef __linux__
+    if (fd >= 0)
+      close(fd);
+#endif
+  }
+
+  bool available( ) const { return fd >= 0; }
+
+  void start( )
+  {
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  long long stop( )
+  {
+    long long count = 0;
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &count, sizeof(count)) != sizeof(count))
+        count = 0;
+    }
+#endif
+    return count;
+  }
+
+private:
+  int fd;
+};
+
+template <typename Alloc>
+void chase(const char* name, size_t n, size_t steps)
+{
+  vector<size_t, Alloc> next(n, size_t(0));
+  // Sattolo's shuffle gives a single cycle through all the elements
+  for (size_t i = 0; i < n; ++i)
+    next[i] = i;
+  std::mt19937_64 e(42);
+  for (size_t i = n - 1; i > 0; --i)
+    std::swap(next[i], next[std::uniform_int_distribution<size_t>(0, i - 1)(e)]);
+
+  tlb_counter counter;
+  size_t cur = 0;
+  counter.start( );
+  const double elapsed = best_time(1, [&]( ) {
+    for (size_t i = 0; i < steps; ++i)
+      cur = next[cur];
+  });
+  const long long misses = counter.stop( );
+  keep(cur);
+
+  printf("%-10s %10.1f ns/access", name, elapsed * 1e9 / steps);
+  if (counter.available( ))
+    printf(" %10.3f dTLB misses/access", double(misses) / steps);
+  printf("\n");
+}
+
+} // namespace bench
+} // namespace ministl
+
+int main(int argc, char* argv[])
+{
+  using namespace ministl;
+  typedef default_alloc_template<false, 0, sgi_size_classes, huge_page_chunk_source> huge_alloc;
+
+  const size_t mib = argc > 1 ? strtoul(argv[1], 0, 10) : 1024;
+  const size_t n = (mib << 20) / sizeof(size_t);
+  const size_t steps = 20000000;
+  printf("%zu MiB, %zu dependent random reads\n", mib, steps);
+  bench::chase<alloc>("malloc", n, steps);
+  bench::chase<huge_alloc>("huge page", n, steps);
+  return 0;
+}
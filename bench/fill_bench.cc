@@ -0,0 +1,84 @@
+// fill over int, double and 16 byte ranges from 16 B to 64 MiB, compared
+// with the element by element loop fill used before the pattern kernels,
+// and each pattern kernel on its own.
+//
+//   g++ -std=c++11 -O2 -I../src fill_bench.cc -o fill_bench
+
+#include <cstdlib>
+#include "bench.h"
+#include "algorithm.h"
+#include "simd.h"
+
+namespace ministl {
+namespace bench {
+
+struct pair16 {
+  long long first;
+  long long second;
+};
+
+// the loop of the old fill, kept scalar
+template <typename T>
+__attribute__((noinline, optimize("no-tree-vectorize")))
+void scalar_fill(T* first, T* last, const T& value)
+{
+  for (; first != last; ++first)
+    *first = value;
+}
+
+// GB/s of f filling bytes bytes, repeated over about 1 GiB in all
+template <typename F>
+double throughput(size_t bytes, F f)
+{
+  const size_t repeats = bytes >= (size_t(1) << 30) ? 1 : (size_t(1) << 30) / bytes;
+  const double elapsed = best_time(3, [&]( ) {
+    for (size_t r = 0; r < repeats; ++r)
+      f( );
+  });
+  return double(bytes) * repeats / elapsed / 1e9;
+}
+
+template <typename T>
+void run(const char* name, const T& value)
+{
+  const size_t max_bytes = size_t(64) << 20;
+  T* data = static_cast<T*>(malloc(max_bytes));
+  char pattern[32];
+  for (size_t i = 0; i < sizeof(pattern); i += sizeof(T))
+    memcpy(pattern + i, &value, sizeof(T));
+
+  printf("%s, GB/s\n", name);
+  printf("%10s %10s %10s %10s %10s %10s\n", "bytes", "fill", "loop", "avx2", "sse2", "scalar");
+  for (size_t bytes = 16; bytes <= max_bytes; bytes *= 4) {
+    T* last = data + bytes / sizeof(T);
+    char* raw = reinterpret_cast<char*>(data);
+    printf("%10zu %10.2f %10.2f", bytes,
+           throughput(bytes, [&]( ) { ministl::fill(data, last, value); keep(*data); }),
+           throughput(bytes, [&]( ) { scalar_fill(data, last, value); keep(*data); }));
+#ifdef MINISTL_SIMD_X86
+    if (simd::has_avx2( ))
+      printf(" %10.2f", throughput(bytes, [&]( ) { simd::fill_pattern_avx2(raw, bytes, pattern); keep(*raw); }));
+    else
+      printf(" %10s", "-");
+    printf(" %10.2f", throughput(bytes, [&]( ) { simd::fill_pattern_sse2(raw, bytes, pattern); keep(*raw); }));
+#else
+    printf(" %10s %10s", "-", "-");
+#endif
+    printf(" %10.2f\n", throughput(bytes, [&]( ) { simd::fill_pattern_scalar(raw, bytes, pattern); keep(*raw); }));
+  }
+  printf("\n");
+  free(data);
+}
+
+} // namespace bench
+} // namespace ministl
+
+int main( )
+{
+  using namespace ministl;
+  bench::run("int", 7);
+  bench::run("double", 0.5);
+  bench::pair16 p = { 1, 2 };
+  bench::run("16 byte struct", p);
+  return 0;
+}
@@ -0,0 +1,48 @@
+// Build, read and destroy many short vectors of 1 to 64 ints, as per-request
+// tag lists or adjacency lists do, with vector and with small_vector of an
+// inline capacity of 8 and 16.
+//
+//   g++ -std=c++11 -O2 -I../src small_vector_bench.cc -o small_vector_bench
+
+#include "bench.h"
+#include "small_vector.h"
+#include "vector.h"
+
+namespace ministl {
+namespace bench {
+
+template <typename Vector>
+double run(size_t size, size_t rounds)
+{
+  long long sum = 0;
+  const double elapsed = best_time(5, [&]( ) {
+    for (size_t r = 0; r < rounds; ++r) {
+      Vector v;
+      for (size_t i = 0; i < size; ++i)
+        v.push_back(int(i + r));
+      for (size_t i = 0; i < v.size( ); ++i)
+        sum += v[i];
+    }
+  });
+  keep(sum);
+  return elapsed * 1e9 / rounds;
+}
+
+} // namespace bench
+} // namespace ministl
+
+int main( )
+{
+  using namespace ministl;
+  const size_t sizes[] = { 1, 2, 4, 8, 12, 16, 32, 64 };
+  const size_t rounds = 1000000;
+
+  printf("ns per vector built, read and destroyed\n");
+  printf("%6s %12s %18s %19s\n", "size", "vector", "small_vector<8>", "small_vector<16>");
+  for (size_t size : sizes) {
+    printf("%6zu %12.1f %18.1f %19.1f\n", size, bench::run<vector<int> >(size, rounds),
+           bench::run<small_vector<int, 8> >(size, rounds),
+           bench::run<small_vector<int, 16> >(size, rounds));
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+// sort, stable_sort, partial_sort and nth_element against their std
+// counterparts, and against the sort_heap fallback used before them, on
+// vectors and deques of ints which are random, already sorted, reversed or
+// have only a few distinct values. The ministl algorithms run on the ministl
+// containers and the std ones on the std containers, since std algorithms
+// do not know the ministl iterator tags. radix_sort is timed on the vector.
+//
+//   g++ -std=c++11 -O2 -I../src sort_bench.cc -o sort_bench
+//   ./sort_bench [elements]
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "deque.h"
+#include "heap.h"
+#include "sort.h"
+#include "vector.h"
+
+namespace ministl {
+namespace bench {
+
+enum input { RANDOM, SORTED, REVERSED, FEW_UNIQUE };
+
+const char* input_name(input in)
+{
+  switch (in) {
+  case RANDOM: return "random";
+  case SORTED: return "sorted";
+  case REVERSED: return "reversed";
+  default: return "few unique";
+  }
+}
+
+std::vector<int> make_input(input in, size_t n)
+{
+  std::vector<int> v(n);
+  std::mt19937 e(42);
+  for (size_t i = 0; i < n; ++i) {
+    switch (in) {
+    case RANDOM: v[i] = int(e( )); break;
+    case SORTED: v[i] = int(i); break;
+    case REVERSED: v[i] = int(n - i); break;
+    case FEW_UNIQUE: v[i] = int(e( ) % 16); break;
+    }
+  }
+  return v;
+}
+
+// ms of f on a fresh copy of data, the copy is not timed
+template <typename Container, typename F>
+double time_ms(const std::vector<int>& data, F f)
+{
+  double best = 1e30;
+  for (int i = 0; i < 3; ++i) {
+    Container c;
+    for (size_t j = 0; j < data.size( ); ++j)
+      c.push_back(data[j]);
+    const double elapsed = best_time(1, [&]( ) { f(c); });
+    keep(c[c.size( ) / 2]);
+    if (elapsed < best)
+      best = elapsed;
+  }
+  return best * 1e3;
+}
+
+template <typename Container, typename StdContainer>
+void run(const char* name, size_t n, bool radix)
+{
+  printf("%s<int>, %zu elements, ms\n", name, n);
+  printf("%-11s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n", "input", "sort", "std", "stable",
+         "std", "partial", "std", "nth", "std", "sort_heap", "radix");
+  const input inputs[] = { RANDOM, SORTED, REVERSED, FEW_UNIQUE };
+  for (input in : inputs) {
+    const std::vector<int> data = make_input(in, n);
+    const size_t k = n / 100;
+    printf("%-11s", input_name(in));
+    printf(" %9.1f", time_ms<Container>(data, [](Container& c) { ministl::sort(c.begin( ), c.end( )); }));
+    printf(" %9.1f", time_ms<StdContainer>(data, [](StdContainer& c) { std::sort(c.begin( ), c.end( )); }));
+    printf(" %9.1f", time_ms<Container>(data, [](Container& c) { ministl::stable_sort(c.begin( ), c.end( )); }));
+    printf(" %9.1f", time_ms<StdContainer>(data, [](StdContainer& c) { std::stable_sort(c.begin( ), c.end( )); }));
+    printf(" %9.1f", time_ms<Container>(data, [k](Container& c) {
+      ministl::partial_sort(c.begin( ), c.begin( ) + k, c.end( ));
+    }));
+    printf(" %9.1f", time_ms<StdContainer>(data, [k](StdContainer& c) {
+      std::partial_sort(c.begin( ), c.begin( ) + k, c.end( ));
+    }));
+    printf(" %9.1f", time_ms<Container>(data, [](Container& c) {
+      ministl::nth_element(c.begin( ), c.begin( ) + c.size( ) / 2, c.end( ));
+    }));
+    printf(" %9.1f", time_ms<StdContainer>(data, [](StdContainer& c) {
+      std::nth_element(c.begin( ), c.begin( ) + c.size( ) / 2, c.end( ));
+    }));
+    printf(" %9.1f", time_ms<Container>(data, [](Container& c) {
+      ministl::make_heap(c.begin( ), c.end( ));
+      ministl::sort_heap(c.begin( ), c.end( ));
+    }));
+    if (radix)
+      printf(" %9.1f", time_ms<Container>(data, [](Container& c) {
+        ministl::radix_sort(&c[0], &c[0] + c.size( ));
+      }));
+    else
+      printf(" %9s", "-");
+    printf("\n");
+  }
+  printf("partial_sort sorts the smallest 1%%, nth_element finds the median\n\n");
+}
+
+} // namespace bench
+} // namespace ministl
+
+int main(int argc, char* argv[])
+{
+  using namespace ministl;
+  const size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 10000000;
+  bench::run<vector<int>, std::vector<int> >("vector", n, true);
+  bench::run<deque<int>, std::deque<int> >("deque", n, false);
+  return 0;
+}
@@ -1,8 +1,12 @@
 #ifndef MINISTL_ALGORITHM_H
 #define MINISTL_ALGORITHM_H
 
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#include <utility>
 #include "pair.h"
+#include "simd.h"
 #include "type_traits.h"
 #include "iterator_base.h"
 
@@ -51,10 +55,10 @@ InputIterator find_if_not(InputIterator first, InputIterator last,
 }
 
 template <typename InputIterator, typename T>
-typename iterator_traits<T>::difference_type
+typename iterator_traits<InputIterator>::difference_type
 count(InputIterator first, InputIterator last, const T& value)
 {
-  typename iterator_traits<T>::difference_type n = 0;
+  typename iterator_traits<InputIterator>::difference_type n = 0;
 
   for (; first != last; ++first) {
     if (*first == value)
@@ -63,6 +67,69 @@ count(InputIterator first, InputIterator last, const T& value)
   return n;
 }
 
+// pointer ranges of arithmetic values are scanned by the simd kernels
+template <typename T>
+inline const T* __find_aux(const T* first, const T* last, const T& x, true_type)
+{
+  if (size_t(last - first) * sizeof(T) < simd::MIN_KERNEL_BYTES) {
+    while (first != last && *first != x)
+      ++first;
+    return first;
+  }
+  return first + simd::find_equal(first, last - first, x);
+}
+
+template <typename T>
+inline const T* __find_aux(const T* first, const T* last, const T& x, false_type)
+{
+  while (first != last && *first != x)
+    ++first;
+  return first;
+}
+
+template <typename T>
+inline const T* find(const T* first, const T* last, const T& x)
+{
+  typedef typename bool_type<simd::has_equal_kernel<T>::value>::type use_kernel;
+  return __find_aux(first, last, x, use_kernel( ));
+}
+
+template <typename T>
+inline T* find(T* first, T* last, const T& x)
+{
+  return const_cast<T*>(find(const_cast<const T*>(first), const_cast<const T*>(last), x));
+}
+
+template <typename T>
+inline ptrdiff_t __count_aux(const T* first, const T* last, const T& value, true_type)
+{
+  return ptrdiff_t(simd::count_equal(first, last - first, value));
+}
+
+template <typename T>
+inline ptrdiff_t __count_aux(const T* first, const T* last, const T& value, false_type)
+{
+  ptrdiff_t n = 0;
+  for (; first != last; ++first) {
+    if (*first == value)
+      ++n;
+  }
+  return n;
+}
+
+template <typename T>
+inline ptrdiff_t count(const T* first, const T* last, const T& value)
+{
+  typedef typename bool_type<simd::has_equal_kernel<T>::value>::type use_kernel;
+  return __count_aux(first, last, value, use_kernel( ));
+}
+
+template <typename T>
+inline ptrdiff_t count(T* first, T* last, const T& value)
+{
+  return count(const_cast<const T*>(first), const_cast<const T*>(last), value);
+}
+
 template <typename InputIterator, typename Predicate>
 typename iterator_traits<InputIterator>::difference_type
 count_if(InputIterator first, InputIterator last, Predicate pred)
@@ -185,56 +252,333 @@ template <typename ForwardIterator, typename Integer,
 //------------------------------------------------------------------------------
 // names of algorithms: search, find_first_of, find_end
 //------------------------------------------------------------------------------
+
+// patterns shorter than this are found by a scan for their first element,
+// longer ones by Boyer-Moore-Horspool
+enum { HORSPOOL_MIN_PATTERN = 8 };
+
+// value is true for iterators over values of one byte, which index the
+// shift table of Horspool
+template <typename Iterator>
+struct __byte_values {
+  typedef typename iterator_traits<Iterator>::value_type value_type;
+  static const bool value = std::is_integral<value_type>::value && sizeof(value_type) == 1;
+  typedef typename bool_type<value>::type type;
+};
+
+// value is true for pointers to values of one byte, which are compared
+// with memchr and memcmp
+template <typename Iterator>
+struct __byte_pointer {
+  static const bool value = false;
+};
+
+template <typename T>
+struct __byte_pointer<T*> {
+  static const bool value = __byte_values<T*>::value;
+};
+
+// value is true when both ranges hold the same value type: the byte paths
+// compare raw bytes, which would match (char)0xff with (unsigned char)0xff
+template <typename Iterator1, typename Iterator2>
+struct __same_values {
+  static const bool value = std::is_same<typename iterator_traits<Iterator1>::value_type,
+                                         typename iterator_traits<Iterator2>::value_type>::value;
+};
+
+// the shift table of Boyer-Moore-Horspool: when the window of the haystack
+// does not match, it moves until its last byte lines up with the last
+// occurrence of that byte among the first m - 1 bytes of the pattern
+struct __horspool_table {
+  size_t shift[256];
+
+  template <typename RandomAccessIterator>
+  void build(RandomAccessIterator pattern, size_t m)
+  {
+    for (size_t i = 0; i < 256; ++i)
+      shift[i] = m;
+    for (size_t i = 0; i + 1 < m; ++i)
+      shift[(unsigned char)pattern[i]] = m - 1 - i;
+  }
+
+  template <typename T>
+  size_t operator[](const T& c) const { return shift[(unsigned char)c]; }
+};
+
+// the pattern has m > 0 elements
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+RandomAccessIterator1 __horspool_search(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                                        RandomAccessIterator2 pattern, size_t m,
+                                        const __horspool_table& table)
+{
+  const size_t n = last1 - first1;
+  if (n < m)
+    return last1;
+  for (size_t pos = 0; pos <= n - m; pos += table[first1[pos + m - 1]]) {
+    if (first1[pos + m - 1] == pattern[m - 1]) {
+      size_t i = 0;
+      while (i + 1 < m && first1[pos + i] == pattern[i])
+        ++i;
+      if (i + 1 == m)
+        return first1 + pos;
+    }
+  }
+  return last1;
+}
+
+// the window is only compared where its first element matches, and never
+// slides past the end of the haystack
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+RandomAccessIterator1 __search_first_element(RandomAccessIterator1 first1,
+                                             RandomAccessIterator1 last1,
+                                             RandomAccessIterator2 pattern, size_t m)
+{
+  const RandomAccessIterator1 limit = last1 - (m - 1);
+  for (; first1 != limit; ++first1) {
+    if (*first1 == *pattern) {
+      size_t i = 1;
+      while (i < m && first1[i] == pattern[i])
+        ++i;
+      if (i == m)
+        return first1;
+    }
+  }
+  return last1;
+}
+
+// contiguous bytes: memchr finds the candidates for the first byte of a short
+// pattern and memcmp checks the rest of it
+inline const unsigned char* __search_bytes(const unsigned char* first1,
+                                           const unsigned char* last1,
+                                           const unsigned char* pattern, size_t m)
+{
+  if (m >= HORSPOOL_MIN_PATTERN) {
+    __horspool_table table;
+    table.build(pattern, m);
+    return __horspool_search(first1, last1, pattern, m, table);
+  }
+  const unsigned char* limit = last1 - (m - 1);
+  while (first1 != limit) {
+    first1 = (const unsigned char*)memchr(first1, *pattern, limit - first1);
+    if (first1 == 0)
+      return last1;
+    if (memcmp(first1 + 1, pattern + 1, m - 1) == 0)
+      return first1;
+    ++first1;
+  }
+  return last1;
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+inline RandomAccessIterator1 __search_values(RandomAccessIterator1 first1,
+                                             RandomAccessIterator1 last1,
+                                             RandomAccessIterator2 pattern, size_t m, true_type)
+{
+  if (m < HORSPOOL_MIN_PATTERN)
+    return __search_first_element(first1, last1, pattern, m);
+  __horspool_table table;
+  table.build(pattern, m);
+  return __horspool_search(first1, last1, pattern, m, table);
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+inline RandomAccessIterator1 __search_values(RandomAccessIterator1 first1,
+                                             RandomAccessIterator1 last1,
+                                             RandomAccessIterator2 pattern, size_t m, false_type)
+{
+  return __search_first_element(first1, last1, pattern, m);
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+inline RandomAccessIterator1 __search_pointers(RandomAccessIterator1 first1,
+                                               RandomAccessIterator1 last1,
+                                               RandomAccessIterator2 pattern, size_t m, true_type)
+{
+  const unsigned char* haystack = reinterpret_cast<const unsigned char*>(first1);
+  const unsigned char* found =
+    __search_bytes(haystack, reinterpret_cast<const unsigned char*>(last1),
+                   reinterpret_cast<const unsigned char*>(pattern), m);
+  return first1 + (found - haystack);
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+inline RandomAccessIterator1 __search_pointers(RandomAccessIterator1 first1,
+                                               RandomAccessIterator1 last1,
+                                               RandomAccessIterator2 pattern, size_t m, false_type)
+{
+  typedef typename bool_type<__byte_values<RandomAccessIterator1>::value &&
+                             __same_values<RandomAccessIterator1,
+                                           RandomAccessIterator2>::value>::type byte_values;
+  return __search_values(first1, last1, pattern, m, byte_values( ));
+}
+
+// forward ranges are compared window by window, a window which reaches the
+// end of the haystack ends the search
+template <typename ForwardIterator1, typename ForwardIterator2>
+ForwardIterator1 __search(ForwardIterator1 first1, ForwardIterator1 last1,
+                          ForwardIterator2 first2, ForwardIterator2 last2,
+                          forward_iterator_tag, forward_iterator_tag)
+{
+  if (first2 == last2)
+    return first1;
+
+  for (; first1 != last1; ++first1) {
+    ForwardIterator1 current1 = first1;
+    ForwardIterator2 current2 = first2;
+    while (*current1 == *current2) {
+      if (++current2 == last2)
+        return first1;
+      if (++current1 == last1)
+        return last1;
+    }
+  }
+  return last1;
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+RandomAccessIterator1 __search(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                               RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                               random_access_iterator_tag, random_access_iterator_tag)
+{
+  const size_t m = last2 - first2;
+  if (m == 0)
+    return first1;
+  if (size_t(last1 - first1) < m)
+    return last1;
+
+  typedef typename bool_type<__byte_pointer<RandomAccessIterator1>::value &&
+                             __byte_pointer<RandomAccessIterator2>::value &&
+                             __same_values<RandomAccessIterator1,
+                                           RandomAccessIterator2>::value>::type byte_pointers;
+  return __search_pointers(first1, last1, first2, m, byte_pointers( ));
+}
+
 template <typename ForwardIterator1, typename ForwardIterator2>
 inline ForwardIterator1 search(ForwardIterator1 first1, ForwardIterator1 last1,
                                ForwardIterator2 first2, ForwardIterator2 last2)
 {
-  return __search(first1, last1, first2, last2, distance_type(first1),
-                  distance_type(first2));
+  typedef typename iterator_traits<ForwardIterator1>::iterator_category category1;
+  typedef typename iterator_traits<ForwardIterator2>::iterator_category category2;
+  return __search(first1, last1, first2, last2, category1( ), category2( ));
 }
 
+// A pattern of byte values compiled once for many searches: the constructor
+// builds the Horspool shift table which search(first, last, searcher) reuses.
+// The pattern range must outlive the searcher. operator() returns the first
+// match as a range, or (last, last) when there is none.
+template <typename RandomAccessIterator>
+class horspool_searcher {
+  static_assert(__byte_values<RandomAccessIterator>::value,
+                "horspool_searcher needs a pattern of byte values");
+
+public:
+  horspool_searcher(RandomAccessIterator first, RandomAccessIterator last)
+    : pattern(first), length(last - first)
+  {
+    table.build(pattern, length);
+  }
 
-template <typename ForwardIterator1, typename ForwardIterator2,
-  typename Distance1, typename Distance2>
-  ForwardIterator1 __search(ForwardIterator1 first1, ForwardIterator2 last1,
-                            ForwardIterator2 first2, ForwardIterator2 last2,
-                            Distance1 *, Distance2 *)
+  template <typename RandomAccessIterator2>
+  pair<RandomAccessIterator2, RandomAccessIterator2>
+  operator()(RandomAccessIterator2 first, RandomAccessIterator2 last) const
+  {
+    if (length == 0)
+      return make_pair(first, first);
+    RandomAccessIterator2 i = __horspool_search(first, last, pattern, length, table);
+    return make_pair(i, i == last ? last : i + length);
+  }
+
+private:
+  RandomAccessIterator pattern;
+  size_t length;
+  __horspool_table table;
+};
+
+template <typename RandomAccessIterator>
+inline horspool_searcher<RandomAccessIterator>
+make_horspool_searcher(RandomAccessIterator first, RandomAccessIterator last)
 {
-  Distance1 d1 = 0;
-  distance(first1, last1, d1);
+  return horspool_searcher<RandomAccessIterator>(first, last);
+}
 
-  Distance2 d2 = 0;
-  distance(first2, last2, d2);
+template <typename ForwardIterator, typename Searcher>
+inline ForwardIterator search(ForwardIterator first, ForwardIterator last,
+                              const Searcher& searcher)
+{
+  return searcher(first, last).first;
+}
 
-  if (d1 < d2) return last1;
+// key sets of this many integers or more are hashed by find_first_of
+enum { HASHED_MIN_KEYS = 16 };
 
-  ForwardIterator1 current1 = first1;
-  ForwardIterator2 current2 = first2;
+// An open addressing set of integer keys with linear probing, at most half
+// full. The keys and their flags share one block from malloc, which keeps
+// algorithm.h independent of the allocators.
+template <typename T>
+class __hashed_key_set {
+public:
+  template <typename ForwardIterator>
+  __hashed_key_set(ForwardIterator first, ForwardIterator last, size_t n) : shift(60)
+  {
+    capacity = 16;
+    while (capacity < 2 * n) {
+      capacity *= 2;
+      --shift;
+    }
+    keys = static_cast<T*>(std::malloc(capacity * (sizeof(T) + 1)));
+    if (keys == 0)
+      throw std::bad_alloc( );
+    used = reinterpret_cast<unsigned char*>(keys + capacity);
+    memset(used, 0, capacity);
+    for (; first != last; ++first)
+      insert(*first);
+  }
 
-  while (current2 != last2) {
-    if (*current1 == *current2) {
-      ++current1;
-      ++current2;
-    } else {
-      if (d1 == d2)
-        return last1;
-      else {
-        current1 = ++first1;
-        current2 = first2;
-        --d1;
-      }
+  ~__hashed_key_set( ) { std::free(keys); }
+
+  bool contains(const T& key) const
+  {
+    for (size_t i = slot(key); used[i]; i = (i + 1) & (capacity - 1)) {
+      if (keys[i] == key)
+        return true;
     }
+    return false;
   }
-  return first1;
-}
 
+private:
+  __hashed_key_set(const __hashed_key_set&);
+  __hashed_key_set& operator=(const __hashed_key_set&);
+
+  // Fibonacci hashing: the top bits of the product are the slot
+  size_t slot(const T& key) const
+  {
+    return size_t(((unsigned long long)key * 0x9e3779b97f4a7c15ull) >> shift);
+  }
+
+  void insert(const T& key)
+  {
+    size_t i = slot(key);
+    for (; used[i]; i = (i + 1) & (capacity - 1)) {
+      if (keys[i] == key)
+        return;
+    }
+    keys[i] = key;
+    used[i] = 1;
+  }
+
+private:
+  T* keys;
+  unsigned char* used;
+  size_t capacity;
+  int shift;
+};
 
 template <typename InputIterator, typename ForwardIterator>
-InputIterator find_first_of(InputIterator first1, InputIterator last1,
-                            ForwardIterator first2, ForwardIterator last2)
+InputIterator __find_first_of_nested(InputIterator first1, InputIterator last1,
+                                     ForwardIterator first2, ForwardIterator last2)
 {
   for (; first1 != last1; ++first1) {
-    for (auto iter = first2; iter != last2; ++first2) {
+    for (ForwardIterator iter = first2; iter != last2; ++iter) {
       if (*first1 == *iter)
         return first1;
     }
@@ -242,6 +586,78 @@ InputIterator find_first_of(InputIterator first1, InputIterator last1,
   return last1;
 }
 
+// contiguous bytes are scanned by the shuffle kernel, other byte ranges look
+// each element up in the bit map of the set
+template <typename InputIterator>
+inline InputIterator __find_byte_set(InputIterator first1, InputIterator last1,
+                                     const simd::byte_set& set, true_type)
+{
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(first1);
+  return first1 + simd::find_byte_set(p, last1 - first1, set);
+}
+
+template <typename InputIterator>
+inline InputIterator __find_byte_set(InputIterator first1, InputIterator last1,
+                                     const simd::byte_set& set, false_type)
+{
+  while (first1 != last1 && !set.contains((unsigned char)*first1))
+    ++first1;
+  return first1;
+}
+
+template <typename InputIterator, typename ForwardIterator>
+InputIterator __find_first_of(InputIterator first1, InputIterator last1,
+                              ForwardIterator first2, ForwardIterator last2,
+                              true_type, false_type)
+{
+  simd::byte_set set;
+  for (; first2 != last2; ++first2)
+    set.insert((unsigned char)*first2);
+  typedef typename bool_type<__byte_pointer<InputIterator>::value>::type contiguous;
+  return __find_byte_set(first1, last1, set, contiguous( ));
+}
+
+template <typename InputIterator, typename ForwardIterator>
+InputIterator __find_first_of(InputIterator first1, InputIterator last1,
+                              ForwardIterator first2, ForwardIterator last2,
+                              false_type, true_type)
+{
+  typedef typename iterator_traits<InputIterator>::value_type value_type;
+  size_t n = 0;
+  for (ForwardIterator i = first2; i != last2; ++i)
+    ++n;
+  if (n < HASHED_MIN_KEYS)
+    return __find_first_of_nested(first1, last1, first2, last2);
+
+  __hashed_key_set<value_type> set(first2, last2, n);
+  while (first1 != last1 && !set.contains(*first1))
+    ++first1;
+  return first1;
+}
+
+template <typename InputIterator, typename ForwardIterator>
+inline InputIterator __find_first_of(InputIterator first1, InputIterator last1,
+                                     ForwardIterator first2, ForwardIterator last2,
+                                     false_type, false_type)
+{
+  return __find_first_of_nested(first1, last1, first2, last2);
+}
+
+// both ranges holding the same integer type, one byte keys are looked up in a
+// 256 bit set and larger sets of wider keys in a hashed set
+template <typename InputIterator, typename ForwardIterator>
+inline InputIterator find_first_of(InputIterator first1, InputIterator last1,
+                                   ForwardIterator first2, ForwardIterator last2)
+{
+  typedef typename iterator_traits<InputIterator>::value_type value_type1;
+  typedef typename iterator_traits<ForwardIterator>::value_type value_type2;
+  static const bool integers =
+    std::is_integral<value_type1>::value && std::is_same<value_type1, value_type2>::value;
+  typedef typename bool_type<integers && sizeof(value_type1) == 1>::type byte_keys;
+  typedef typename bool_type<integers && sizeof(value_type1) != 1>::type wide_keys;
+  return __find_first_of(first1, last1, first2, last2, byte_keys( ), wide_keys( ));
+}
+
 
 template <typename InputIterator, typename ForwardIterator, typename BinaryPredicate>
 InputIterator find_first_of(InputIterator first1, InputIterator last1,
@@ -249,7 +665,7 @@ InputIterator find_first_of(InputIterator first1, InputIterator last1,
                             BinaryPredicate comp)
 {
   for (; first1 != last1; ++first1) {
-    for (auto iter = first2; iter != last2; ++first2) {
+    for (ForwardIterator iter = first2; iter != last2; ++iter) {
       if (comp(*first1, *iter))
         return first1;
     }
@@ -339,19 +755,18 @@ bool equal(InputIterator1 first1, InputIterator1 last1,
 template <typename ForwardIterator1, typename ForwardIterator2>
 inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b)
 {
-
-  typename iterator_traits<ForwardIterator1>::value_type T tmp = *a;
-  *a = *b;
-  *b = tmp;
+  typename iterator_traits<ForwardIterator1>::value_type tmp = std::move(*a);
+  *a = std::move(*b);
+  *b = std::move(tmp);
 }
 
 // algorithm swap
 template <typename T>
 inline void swap(T &a, T &b)
 {
-  T tmp = a;
-  a = b;
-  b = tmp;
+  T tmp = std::move(a);
+  a = std::move(b);
+  b = std::move(tmp);
 }
 
 
@@ -542,6 +957,52 @@ OutputIter fill_n(OutputIter first, Size n, const Tp& value)
   return first;
 }
 
+// pointer ranges of values of 1, 2, 4, 8 or 16 bytes which are assigned
+// bitwise are filled with a repeated pattern by the simd kernels
+template <typename Tp>
+struct __fill_kernel {
+  enum {
+    value = std::is_trivially_copy_assignable<Tp>::value &&
+            (sizeof(Tp) == 1 || sizeof(Tp) == 2 || sizeof(Tp) == 4 ||
+             sizeof(Tp) == 8 || sizeof(Tp) == 16)
+  };
+};
+
+template <typename Tp>
+inline void __fill_aux(Tp* first, Tp* last, const Tp& value, true_type)
+{
+  const size_t bytes = (last - first) * sizeof(Tp);
+  if (bytes < simd::MIN_KERNEL_BYTES) {
+    for (; first != last; ++first)
+      *first = value;
+  } else {
+    simd::fill_pattern(first, bytes, &value, sizeof(Tp));
+  }
+}
+
+template <typename Tp>
+inline void __fill_aux(Tp* first, Tp* last, const Tp& value, false_type)
+{
+  for (; first != last; ++first)
+    *first = value;
+}
+
+template <typename Tp>
+inline void fill(Tp* first, Tp* last, const Tp& value)
+{
+  typedef typename bool_type<__fill_kernel<Tp>::value>::type use_kernel;
+  __fill_aux(first, last, value, use_kernel( ));
+}
+
+template <typename Tp, typename Size>
+inline Tp* fill_n(Tp* first, Size n, const Tp& value)
+{
+  if (n <= 0)
+    return first;
+  fill(first, first + n, value);
+  return first + n;
+}
+
 // Specialization: for one-byte types we can use memset.
 inline void fill(unsigned char* first, unsigned char* last,
                  const unsigned char &c)
@@ -632,6 +1093,57 @@ inline BidirectionalIter __copy_backward(RandomAccessIter first,
 }
 
 
+// algorithm: move and move_backward, elements with a trivial assignment are
+// copied, which takes the memmove path of copy and copy_backward
+template <typename InputIterator, typename OutputIterator>
+inline OutputIterator __move_aux(InputIterator first, InputIterator last,
+                                 OutputIterator result, true_type)
+{
+  return copy(first, last, result);
+}
+
+template <typename InputIterator, typename OutputIterator>
+inline OutputIterator __move_aux(InputIterator first, InputIterator last,
+                                 OutputIterator result, false_type)
+{
+  for (; first != last; ++first, ++result)
+    *result = std::move(*first);
+  return result;
+}
+
+template <typename InputIterator, typename OutputIterator>
+inline OutputIterator move(InputIterator first, InputIterator last, OutputIterator result)
+{
+  typedef typename type_traits<typename iterator_traits<OutputIterator>::value_type>
+    ::has_trivial_assignment_operator Trivial;
+  return __move_aux(first, last, result, Trivial( ));
+}
+
+template <typename BidirectionalIter1, typename BidirectionalIter2>
+inline BidirectionalIter2 __move_backward_aux(BidirectionalIter1 first, BidirectionalIter1 last,
+                                              BidirectionalIter2 result, true_type)
+{
+  return copy_backward(first, last, result);
+}
+
+template <typename BidirectionalIter1, typename BidirectionalIter2>
+inline BidirectionalIter2 __move_backward_aux(BidirectionalIter1 first, BidirectionalIter1 last,
+                                              BidirectionalIter2 result, false_type)
+{
+  while (first != last)
+    *--result = std::move(*--last);
+  return result;
+}
+
+template <typename BidirectionalIter1, typename BidirectionalIter2>
+inline BidirectionalIter2 move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                                        BidirectionalIter2 result)
+{
+  typedef typename type_traits<typename iterator_traits<BidirectionalIter2>::value_type>
+    ::has_trivial_assignment_operator Trivial;
+  return __move_backward_aux(first, last, result, Trivial( ));
+}
+
 template <typename ForwardIterator, typename Generator>
 void generate(ForwardIterator first, ForwardIterator last, Generator gen)
 {
@@ -1,34 +1,189 @@
 #ifndef MINISTL_ALLOC_H
 #define MINISTL_ALLOC_H
 
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <mutex>
+#include <cstdio>
+#include "type_traits.h"
+#ifdef MINISTL_ALLOC_STATS
+#include <atomic>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 #define THROW_BAD_ALLOC throw std::bad_alloc()
 
 namespace ministl {
 
-template <int inst>
+// A chunk source provides the blocks of memory malloc_alloc_template and the
+// chunks of default_alloc_template are made of. allocate returns 0 when out
+// of memory and the size given to deallocate and reallocate is always the
+// size the block was allocated with. Chunks of the pool are rounded up to
+// chunk_granularity bytes, good_size(n) is the number of bytes a block of n
+// bytes really provides.
+struct malloc_chunk_source {
+    enum { chunk_granularity = 8 };
+
+    static size_t good_size(size_t n) { return (n + chunk_granularity - 1) & ~size_t(chunk_granularity - 1); }
+
+    static void *allocate(size_t n) { return malloc(n); }
+    static void deallocate(void *p, size_t /* n */) { free(p); }
+    static void *reallocate(void *p, size_t /* old_sz */, size_t new_sz) { return realloc(p, new_sz); }
+};
+
+// maps blocks of at least HUGE_PAGE_THRESHOLD bytes aligned to huge pages and
+// asks for transparent huge pages with MADV_HUGEPAGE, the pages stay normal
+// ones if the kernel does not provide them. Smaller blocks come from malloc,
+// as do all blocks on systems other than Linux.
+struct huge_page_chunk_source {
+    enum { HUGE_PAGE_SIZE = 2 << 20 };
+    enum { HUGE_PAGE_THRESHOLD = 1 << 20 };
+    enum { chunk_granularity = HUGE_PAGE_SIZE };
+
+    static size_t mapped_size(size_t n) { return (n + HUGE_PAGE_SIZE - 1) & ~size_t(HUGE_PAGE_SIZE - 1); }
+
+    static size_t good_size(size_t n)
+    {
+#ifdef __linux__
+        if (n >= (size_t)HUGE_PAGE_THRESHOLD)
+            return mapped_size(n);
+#endif
+        return malloc_chunk_source::good_size(n);
+    }
+
+    static void *allocate(size_t n)
+    {
+#ifdef __linux__
+        if (n >= (size_t)HUGE_PAGE_THRESHOLD) {
+            const size_t len = mapped_size(n);
+            // map one more huge page to be able to align the block
+            char *raw = (char *)mmap(0, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == (char *)MAP_FAILED)
+                return 0;
+            char *result = (char *)(((size_t)raw + HUGE_PAGE_SIZE - 1) & ~size_t(HUGE_PAGE_SIZE - 1));
+            if (result != raw)
+                munmap(raw, result - raw);
+            if (result + len != raw + len + HUGE_PAGE_SIZE)
+                munmap(result + len, raw + HUGE_PAGE_SIZE - result);
+#ifdef MADV_HUGEPAGE
+            madvise(result, len, MADV_HUGEPAGE);
+#endif
+            return result;
+        }
+#endif
+        return malloc(n);
+    }
+
+    static void deallocate(void *p, size_t n)
+    {
+#ifdef __linux__
+        if (n >= (size_t)HUGE_PAGE_THRESHOLD) {
+            munmap(p, mapped_size(n));
+            return;
+        }
+#endif
+        free(p);
+    }
+
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+#ifdef __linux__
+        const bool old_mapped = old_sz >= (size_t)HUGE_PAGE_THRESHOLD;
+        const bool new_mapped = new_sz >= (size_t)HUGE_PAGE_THRESHOLD;
+        if (old_mapped && new_mapped) {
+            if (mapped_size(old_sz) == mapped_size(new_sz))
+                return p;
+            // move the page tables instead of copying the pages
+            void *result = mremap(p, mapped_size(old_sz), mapped_size(new_sz), MREMAP_MAYMOVE);
+            return result == MAP_FAILED ? 0 : result;
+        }
+        if (old_mapped || new_mapped) {
+            void *result = allocate(new_sz);
+            if (result != 0) {
+                memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+                deallocate(p, old_sz);
+            }
+            return result;
+        }
+#endif
+        (void)old_sz;
+        return realloc(p, new_sz);
+    }
+};
+
+template <int inst, typename ChunkSource = malloc_chunk_source>
 class malloc_alloc_template {
 private:
     // function used to deal with the situation that no memory exists
     // oom: out of memory
     static void *oom_malloc(size_t);
-    static void *oom_realloc(void *, size_t);
+    static void *oom_realloc(void *, size_t, size_t);
+    static void *oom_aligned_malloc(size_t, size_t);
     static void(*malloc_alloc_oom_handler)();
 
+    static void *aligned_malloc(size_t n, size_t align)
+    {
+#ifdef _WIN32
+        return _aligned_malloc(n, align);
+#else
+        void *result;
+        if (align < sizeof(void *))
+            align = sizeof(void *);
+        return posix_memalign(&result, align, n) == 0 ? result : 0;
+#endif
+    }
+
 public:
     static void *allocate(size_t n)
     {
-        void *result = malloc(n);
+        void *result = ChunkSource::allocate(n);
         if (result == 0)
             result = oom_malloc(n);
         return result;
     }
 
-    static void deallocate(void *p, size_t /* n */) { free(p); }
-    static void *reallocate(void *p, size_t /* old_sz */, size_t new_sz)
+    static void deallocate(void *p, size_t n) { ChunkSource::deallocate(p, n); }
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz)
     {
-        void *result = realloc(p, new_sz);
+        void *result = ChunkSource::reallocate(p, old_sz, new_sz);
         if (0 == result)
-            result = oom_realloc(p, new_sz);
+            result = oom_realloc(p, old_sz, new_sz);
+        return result;
+    }
+
+    // the number of bytes usable in a block allocated for n bytes
+    static size_t good_size(size_t n) { return ChunkSource::good_size(n); }
+
+    // align must be a power of two, memory returned by allocate_aligned must
+    // be given back through deallocate_aligned. It does not come from
+    // ChunkSource.
+    static void *allocate_aligned(size_t n, size_t align)
+    {
+        void *result = aligned_malloc(n, align);
+        if (result == 0)
+            result = oom_aligned_malloc(n, align);
+        return result;
+    }
+
+    static void deallocate_aligned(void *p, size_t /* n */, size_t /* align */)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    static void *reallocate_aligned(void *p, size_t old_sz, size_t new_sz, size_t align)
+    {
+        void *result = allocate_aligned(new_sz, align);
+        memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+        deallocate_aligned(p, old_sz, align);
         return result;
     }
 
@@ -42,10 +197,11 @@ public:
     }
 };
 
-template <int inst> void(*malloc_alloc_template<inst>::malloc_alloc_oom_handler)() = 0;
+template <int inst, typename ChunkSource>
+void(*malloc_alloc_template<inst, ChunkSource>::malloc_alloc_oom_handler)() = 0;
 
-template <int inst>
-void *malloc_alloc_template<inst>::oom_malloc(size_t n)
+template <int inst, typename ChunkSource>
+void *malloc_alloc_template<inst, ChunkSource>::oom_malloc(size_t n)
 {
     void(*my_malloc_handler)();
     void *result;
@@ -56,14 +212,14 @@ void *malloc_alloc_template<inst>::oom_malloc(size_t n)
             THROW_BAD_ALLOC;
         }
         (*my_malloc_handler)();
-        result = malloc(n);
+        result = ChunkSource::allocate(n);
         if (result)
             return result;
     }
 }
 
-template <int inst>
-void *malloc_alloc_template<inst>::oom_realloc(void *p, size_t n)
+template <int inst, typename ChunkSource>
+void *malloc_alloc_template<inst, ChunkSource>::oom_realloc(void *p, size_t old_sz, size_t n)
 {
     void(*my_malloc_handler)();
     void *result;
@@ -74,40 +230,229 @@ void *malloc_alloc_template<inst>::oom_realloc(void *p, size_t n)
             THROW_BAD_ALLOC;
         }
         (*my_malloc_handler)();
-        result = realloc(p, n);
+        result = ChunkSource::reallocate(p, old_sz, n);
         if (result)
             return result;
     }
 }
 
-typedef malloc_alloc_template<0> malloc_alloc;
+template <int inst, typename ChunkSource>
+void *malloc_alloc_template<inst, ChunkSource>::oom_aligned_malloc(size_t n, size_t align)
+{
+    void(*my_malloc_handler)();
+    void *result;
 
-template <typename T, typename Alloc>
-class simple_alloc {
-public:
-    static T *allocate(size_t n) { return 0 == n ? 0 : (T*)Alloc::allocate(n * sizeof(T)); }
-    static T *allocate( ) { return (T*)Alloc::allocate(sizeof(T)); }
-    static void deallocate(T *p, size_t n) { if (0 != n) Alloc::deallocate(p, n); }
-    static void deallocate(T *p) { Alloc::deallocate(p, sizeof(T)); }
-};
+    for (;;) {
+        my_malloc_handler = malloc_alloc_oom_handler;
+        if (0 == my_malloc_handler) {
+            THROW_BAD_ALLOC;
+        }
+        (*my_malloc_handler)();
+        result = aligned_malloc(n, align);
+        if (result)
+            return result;
+    }
+}
+
+typedef malloc_alloc_template<0> malloc_alloc;
 
 
 enum { ALIGN = 8 };
 enum { MAX_BYTES = 128 };
 enum { NFREELISTS = MAX_BYTES / ALIGN };
+enum { MAX_SIZE_CLASSES = 64 };
+
+// A size class policy of default_alloc_template maps a request of at most
+// max_bytes bytes to one of nclasses free lists, every class size being a
+// multiple of ALIGN.
+
+// the SGI size classes: multiples of ALIGN up to MAX_BYTES
+struct sgi_size_classes {
+    enum { max_bytes = MAX_BYTES, nclasses = NFREELISTS };
+
+    static size_t index(size_t bytes) { return (bytes + ALIGN - 1) / ALIGN - 1; }
+    static size_t class_size(size_t index) { return (index + 1) * ALIGN; }
+};
+
+// the SGI size classes up to MAX_BYTES, then four classes for each power of
+// two up to MaxBytes: 160, 192, 224, 256, 320, 384, ...
+template <size_t MaxBytes>
+struct geometric_size_classes {
+private:
+    static constexpr size_t log2(size_t n) { return n <= 1 ? 0 : 1 + log2(n >> 1); }
+    static size_t floor_log2(size_t n)
+    {
+        size_t result = 0;
+        while (n >>= 1)
+            ++result;
+        return result;
+    }
+
+    enum { sgi_classes = NFREELISTS, sgi_log2 = 7 };
+    static_assert(MAX_BYTES == 1 << sgi_log2, "geometric classes start after MAX_BYTES");
+    static_assert(MaxBytes > MAX_BYTES && (MaxBytes & (MaxBytes - 1)) == 0,
+                  "MaxBytes must be a power of two greater than MAX_BYTES");
+
+public:
+    enum : size_t { max_bytes = MaxBytes, nclasses = sgi_classes + 4 * (log2(MaxBytes) - sgi_log2) };
+
+    static size_t index(size_t bytes)
+    {
+        if (bytes <= (size_t)MAX_BYTES)
+            return sgi_size_classes::index(bytes);
+        size_t group = floor_log2(bytes - 1);
+        return sgi_classes + 4 * (group - sgi_log2) + ((bytes - 1) >> (group - 2)) - 4;
+    }
+
+    static size_t class_size(size_t index)
+    {
+        if (index < (size_t)sgi_classes)
+            return sgi_size_classes::class_size(index);
+        index -= sgi_classes;
+        return (index % 4 + 5) << (index / 4 + sgi_log2 - 2);
+    }
+};
 
-template <bool threads, int inst>
+// statistics of one size class of default_alloc_template. The event counters
+// are only maintained when MINISTL_ALLOC_STATS is defined and stay 0 otherwise.
+struct alloc_class_stats {
+    size_t object_size;
+    size_t allocations;
+    size_t deallocations;
+    size_t live_objects;
+    size_t free_bytes;          // bytes in the shared free list
+    // bytes loaded into the magazines of all threads and not flushed back yet,
+    // the free objects cached there and the live objects handed out from
+    // them. With MINISTL_ALLOC_STATS, magazine_bytes - live_objects *
+    // object_size are the free bytes cached in the magazines.
+    size_t magazine_bytes;
+};
+
+struct alloc_stats {
+    alloc_class_stats classes[MAX_SIZE_CLASSES];
+    size_t class_count;
+    size_t chunk_count;
+    size_t heap_size;           // bytes of all chunks held by the pool
+    size_t pool_bytes;          // bytes of the current chunk not carved yet
+    size_t large_allocations;   // requests larger than the largest class
+    size_t large_deallocations;
+};
+
+// when threads is true, every thread allocates from its own magazines, one per
+// free list. The free lists and the chunk pool then act as a depot shared by
+// all threads, magazines are loaded from and flushed to it in batches of at
+// most MAGAZINE_BATCH objects and every access to it is serialized by alloc_mutex
+template <bool threads, int inst, typename SizeClasses = sgi_size_classes,
+          typename ChunkSource = malloc_chunk_source>
 class default_alloc_template {
 private:
+    // requests too large for the size classes, malloc_alloc for the default source
+    typedef malloc_alloc_template<0, ChunkSource> large_alloc;
+
+    enum { NCLASSES = SizeClasses::nclasses };
+    static_assert((size_t)NCLASSES <= (size_t)MAX_SIZE_CLASSES, "too many size classes");
+
     static size_t ROUND_UP(size_t bytes) { return ((bytes) + ALIGN - 1) & ~(ALIGN - 1); }
+    static size_t CLASS_SIZE(size_t bytes) { return SizeClasses::class_size(SizeClasses::index(bytes)); }
+    static size_t FREELIST_INDEX(size_t bytes) { return SizeClasses::index(bytes); }
+    static bool is_large(size_t bytes) { return bytes > (size_t)SizeClasses::max_bytes; }
+private:
+    // scoped guard of the allocator state, it does nothing if threads is false
+    class lock {
+    public:
+        lock( ) { if (threads) alloc_mutex.lock( ); }
+        ~lock( ) { if (threads) alloc_mutex.unlock( ); }
+    private:
+        lock(const lock&);
+        lock& operator=(const lock&);
+    };
+    friend class lock;
+
+    static std::mutex alloc_mutex;
+
 private:
     union obj {
         union obj *free_list_link;
         char client_data[1];
     };
+
+private:
+    // a magazine holds at most MAGAZINE_BYTES worth of objects in one batch
+    enum { MAGAZINE_BATCH = 32, MAGAZINE_BYTES = 8192 };
+
+    static size_t magazine_batch(size_t index)
+    {
+        size_t batch = MAGAZINE_BYTES / SizeClasses::class_size(index);
+        return batch == 0 ? 1 : (batch > (size_t)MAGAZINE_BATCH ? (size_t)MAGAZINE_BATCH : batch);
+    }
+
+    // a per-thread stack of free objects of one size class
+    struct magazine {
+        obj *head;
+        size_t count;
+    };
+
+    // the magazines owned by one thread, given back to the depot at thread exit
+    struct magazine_rack {
+        magazine mags[NCLASSES];
+
+        magazine_rack( ) { memset(mags, 0, sizeof(mags)); }
+        ~magazine_rack( )
+        {
+            for (size_t i = 0; i < NCLASSES; ++i)
+                flush_magazine(mags[i], i, mags[i].count);
+        }
+    };
+
+    static magazine_rack &local_rack( )
+    {
+        static thread_local magazine_rack rack;
+        return rack;
+    }
+
+#ifdef MINISTL_ALLOC_STATS
+    struct event_counters {
+        std::atomic<size_t> allocations[NCLASSES];
+        std::atomic<size_t> deallocations[NCLASSES];
+        std::atomic<size_t> large_allocations;
+        std::atomic<size_t> large_deallocations;
+    };
+    static event_counters counters;
+#endif
+
+    static void count_allocate(size_t n)
+    {
+#ifdef MINISTL_ALLOC_STATS
+        if (is_large(n))
+            counters.large_allocations.fetch_add(1, std::memory_order_relaxed);
+        else
+            counters.allocations[FREELIST_INDEX(n)].fetch_add(1, std::memory_order_relaxed);
+#else
+        (void)n;
+#endif
+    }
+
+    static void count_deallocate(size_t n)
+    {
+#ifdef MINISTL_ALLOC_STATS
+        if (is_large(n))
+            counters.large_deallocations.fetch_add(1, std::memory_order_relaxed);
+        else
+            counters.deallocations[FREELIST_INDEX(n)].fetch_add(1, std::memory_order_relaxed);
+#else
+        (void)n;
+#endif
+    }
+
+    static void load_magazine(magazine &mag, size_t n);
+    static void flush_magazine(magazine &mag, size_t index, size_t nobjs);
 private:
-    static obj *volatile free_list[NFREELISTS];
-    static size_t FREELIST_INDEX(size_t bytes) { return (((bytes)+ALIGN - 1) / ALIGN - 1); }
+    static obj *volatile free_list[NCLASSES];
+    // the number of objects in each free list and in all the magazines of a
+    // size class, kept under the lock so that get_stats need not walk them
+    static size_t free_count[NCLASSES];
+    static size_t magazine_count[NCLASSES];
+    static int refill_count(size_t n) { return n <= 1024 ? 20 : (n <= 8192 ? 8 : 2); }
     static void *refill(size_t n);
     static char *chunk_alloc(size_t size, int &nobjs);
 
@@ -116,21 +461,46 @@ private:
     static char *end_free;
     static size_t heap_size;
 
+    // every chunk obtained from ChunkSource, sorted by address
+    struct chunk_info {
+        char *base;
+        size_t size;
+        size_t free_bytes;
+    };
+    static chunk_info *chunks;
+    static size_t chunk_count;
+    static size_t chunk_capacity;
+
+    static void reserve_chunk_slot( );
+    static void register_chunk(char *base, size_t size);
+    static chunk_info *find_chunk(const void *p);
+
 public:
     static void *allocate(size_t n)
     {
         obj *volatile *my_free_list;
         obj *result;
 
-        if (n > (size_t)MAX_BYTES)
-            return (malloc_alloc::allocate(n));
+        count_allocate(n);
+        if (is_large(n))
+            return (large_alloc::allocate(n));
+        if (threads) {
+            magazine &mag = local_rack( ).mags[FREELIST_INDEX(n)];
+            if (mag.head == 0)
+                load_magazine(mag, CLASS_SIZE(n));
+            result = mag.head;
+            mag.head = result->free_list_link;
+            --mag.count;
+            return (result);
+        }
         my_free_list = free_list + FREELIST_INDEX(n);
         result = *my_free_list;
         if (result == 0) {
-            void *r = refill(ROUND_UP(n));
+            void *r = refill(CLASS_SIZE(n));
             return r;
         }
         *my_free_list = result->free_list_link;
+        --free_count[FREELIST_INDEX(n)];
         return (result);
     }
 
@@ -139,37 +509,170 @@ public:
         obj *q = (obj *)p;
         obj *volatile *my_free_list;
 
-        if (n > (size_t)MAX_BYTES) {
-            malloc_alloc::deallocate(p, n);
+        count_deallocate(n);
+        if (is_large(n)) {
+            large_alloc::deallocate(p, n);
+            return;
+        }
+        if (threads) {
+            magazine &mag = local_rack( ).mags[FREELIST_INDEX(n)];
+            q->free_list_link = mag.head;
+            mag.head = q;
+            if (++mag.count >= 2 * magazine_batch(FREELIST_INDEX(n)))
+                flush_magazine(mag, FREELIST_INDEX(n), magazine_batch(FREELIST_INDEX(n)));
             return;
         }
         my_free_list = free_list + FREELIST_INDEX(n);
         q->free_list_link = *my_free_list;
         *my_free_list = q;
+        ++free_count[FREELIST_INDEX(n)];
     }
 
     static void *reallocate(void *p, size_t old_sz, size_t new_sz);
+
+    // the number of bytes usable in a block allocated for n bytes, which is
+    // the size of its size class
+    static size_t good_size(size_t n) { return is_large(n) ? large_alloc::good_size(n) : CLASS_SIZE(n); }
+
+    // the pool only guarantees ALIGN, larger alignments come from malloc_alloc
+    static void *allocate_aligned(size_t n, size_t align)
+    {
+        if (align <= (size_t)ALIGN)
+            return allocate(n);
+        return malloc_alloc::allocate_aligned(n, align);
+    }
+
+    static void deallocate_aligned(void *p, size_t n, size_t align)
+    {
+        if (align <= (size_t)ALIGN)
+            deallocate(p, n);
+        else
+            malloc_alloc::deallocate_aligned(p, n, align);
+    }
+
+    static void *reallocate_aligned(void *p, size_t old_sz, size_t new_sz, size_t align)
+    {
+        if (align <= (size_t)ALIGN)
+            return reallocate(p, old_sz, new_sz);
+        return malloc_alloc::reallocate_aligned(p, old_sz, new_sz, align);
+    }
+
+    // give every chunk whose objects are all back in the free lists to the
+    // system and return the number of bytes released. Objects cached in the
+    // magazines of other threads keep their chunks alive.
+    static size_t release_unused( );
+
+    // find the chunk of the pool which contains p, returns false if p was not
+    // carved from this pool
+    static bool chunk_of(const void *p, const char *&base, size_t &size)
+    {
+        lock guard;
+        chunk_info *chunk = find_chunk(p);
+        if (chunk == 0)
+            return false;
+        base = chunk->base;
+        size = chunk->size;
+        return true;
+    }
+
+    // take a snapshot of the allocator state
+    static void get_stats(alloc_stats &stats);
+    static void dump_stats(FILE *out);
 };
 
-template <bool threads, int inst>
-char *default_alloc_template<threads, inst>::start_free = 0;
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+std::mutex default_alloc_template<threads, inst, SizeClasses, ChunkSource>::alloc_mutex;
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+char *default_alloc_template<threads, inst, SizeClasses, ChunkSource>::start_free = 0;
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+char *default_alloc_template<threads, inst, SizeClasses, ChunkSource>::end_free = 0;
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::heap_size = 0;
 
-template <bool threads, int inst>
-char *default_alloc_template<threads, inst>::end_free = 0;
+#ifdef MINISTL_ALLOC_STATS
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+typename default_alloc_template<threads, inst, SizeClasses, ChunkSource>::event_counters
+    default_alloc_template<threads, inst, SizeClasses, ChunkSource>::counters;
+#endif
 
-template <bool threads, int inst>
-size_t default_alloc_template<threads, inst>::heap_size = 0;
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+typename default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunk_info *
+    default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunks = 0;
 
-template <bool threads, int inst>
-typename default_alloc_template<threads, inst>::obj *volatile
-    default_alloc_template<threads, inst>::free_list[NFREELISTS] =
-{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunk_count = 0;
 
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunk_capacity = 0;
 
-template <bool threads, int inst>
-void *default_alloc_template<threads, inst>::refill(size_t n)
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+typename default_alloc_template<threads, inst, SizeClasses, ChunkSource>::obj *volatile
+    default_alloc_template<threads, inst, SizeClasses, ChunkSource>::free_list[NCLASSES] = { 0 };
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::free_count[NCLASSES] = { 0 };
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::magazine_count[NCLASSES] = { 0 };
+
+
+// move up to one batch of objects of size n from the depot into mag
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::load_magazine(magazine &mag, size_t n)
+{
+    const size_t index = FREELIST_INDEX(n);
+    obj *volatile *my_free_list = free_list + index;
+    obj *p;
+
+    const size_t batch = magazine_batch(index);
+
+    lock guard;
+    while (mag.count < batch) {
+        p = *my_free_list;
+        if (0 == p) {
+            if (0 != mag.count)
+                break;
+            p = (obj *)refill(n);
+        } else {
+            *my_free_list = p->free_list_link;
+            --free_count[index];
+        }
+        p->free_list_link = mag.head;
+        mag.head = p;
+        ++mag.count;
+        ++magazine_count[index];
+    }
+}
+
+// give nobjs objects of mag back to the depot
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::flush_magazine(magazine &mag, size_t index,
+                                                           size_t nobjs)
+{
+    obj *volatile *my_free_list = free_list + index;
+    obj *p;
+
+    if (0 == nobjs)
+        return;
+    lock guard;
+    free_count[index] += nobjs;
+    magazine_count[index] -= nobjs;
+    for (; nobjs > 0; --nobjs) {
+        p = mag.head;
+        mag.head = p->free_list_link;
+        --mag.count;
+        p->free_list_link = *my_free_list;
+        *my_free_list = p;
+    }
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void *default_alloc_template<threads, inst, SizeClasses, ChunkSource>::refill(size_t n)
 {
-    int nobjs = 20;
+    int nobjs = refill_count(n);
 
     char *chunk = chunk_alloc(n, nobjs);
     obj *volatile *my_free_list;
@@ -182,6 +685,7 @@ void *default_alloc_template<threads, inst>::refill(size_t n)
     my_free_list = free_list + FREELIST_INDEX(n);
 
     result = (obj *)chunk;
+    free_count[FREELIST_INDEX(n)] += nobjs - 1;
     *my_free_list = next_obj = (obj *)(chunk + n);
     for (i = 1;; ++i) {
         current_obj = next_obj;
@@ -196,8 +700,8 @@ void *default_alloc_template<threads, inst>::refill(size_t n)
     return (result);
 }
 
-template <bool threads, int inst>
-char *default_alloc_template<threads, inst>::chunk_alloc(size_t size, int& nobjs)
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+char *default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunk_alloc(size_t size, int& nobjs)
 {
     char *result;
     size_t total_bytes = size * nobjs;
@@ -215,44 +719,212 @@ char *default_alloc_template<threads, inst>::chunk_alloc(size_t size, int& nobjs
         return(result);
     } else {
         size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
-        if (byte_left > 0) {
-            obj *volatile *my_free_list = free_list + FREELIST_INDEX(byte_left);
+        bytes_to_get = (bytes_to_get + ChunkSource::chunk_granularity - 1)
+                       & ~size_t(ChunkSource::chunk_granularity - 1);
+        // hand the rest of the pool to the largest classes it fits in
+        while (byte_left > 0) {
+            size_t index = FREELIST_INDEX(byte_left);
+            if (SizeClasses::class_size(index) > byte_left)
+                --index;
+            size_t piece = SizeClasses::class_size(index);
+            obj *volatile *my_free_list = free_list + index;
             ((obj *)start_free)->free_list_link = *my_free_list;
             *my_free_list = (obj *)start_free;
+            ++free_count[index];
+            start_free += piece;
+            byte_left -= piece;
         }
         // allocate memory for heap
-        start_free = (char *)malloc(bytes_to_get);
+        reserve_chunk_slot( );
+        start_free = (char *)ChunkSource::allocate(bytes_to_get);
         if (0 == start_free) {
-            int i;
+            size_t i;
             obj *volatile *my_free_list, *p;
 
-            for (i = size; i <= MAX_BYTES; i += ALIGN) {
-                my_free_list = free_list + FREELIST_INDEX(i);
+            for (i = FREELIST_INDEX(size); i < NCLASSES; ++i) {
+                my_free_list = free_list + i;
                 p = *my_free_list;
 
                 if (0 != p) {
                     *my_free_list = p->free_list_link;
+                    --free_count[i];
                     start_free = (char *)p;
-                    end_free = start_free + i;
+                    end_free = start_free + SizeClasses::class_size(i);
                     return (chunk_alloc(size, nobjs));
                 }
             }
             end_free = 0;
-            start_free = (char *)malloc_alloc::allocate(bytes_to_get);
+            start_free = (char *)large_alloc::allocate(bytes_to_get);
         }
+        register_chunk(start_free, bytes_to_get);
         heap_size += bytes_to_get;
         end_free = start_free + bytes_to_get;
         return (chunk_alloc(size, nobjs));
     }
 }
 
-template <bool threads, int inst>
-void* default_alloc_template<threads, inst>::reallocate(void* p, size_t old_sz, size_t new_sz)
+// make sure register_chunk can not fail once the chunk has been allocated
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::reserve_chunk_slot( )
+{
+    if (chunk_count < chunk_capacity)
+        return;
+    size_t new_capacity = chunk_capacity != 0 ? 2 * chunk_capacity : 16;
+    chunks = (chunk_info *)malloc_alloc::reallocate(chunks, chunk_capacity * sizeof(chunk_info),
+                                                    new_capacity * sizeof(chunk_info));
+    chunk_capacity = new_capacity;
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::register_chunk(char *base, size_t size)
+{
+    size_t i = chunk_count;
+    for (; i > 0 && chunks[i - 1].base > base; --i)
+        chunks[i] = chunks[i - 1];
+    chunks[i].base = base;
+    chunks[i].size = size;
+    chunks[i].free_bytes = 0;
+    ++chunk_count;
+}
+
+// return the chunk which contains p, or 0 if p was not carved from a chunk
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+typename default_alloc_template<threads, inst, SizeClasses, ChunkSource>::chunk_info *
+default_alloc_template<threads, inst, SizeClasses, ChunkSource>::find_chunk(const void *p)
+{
+    const char *addr = (const char *)p;
+    size_t low = 0, high = chunk_count;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (chunks[mid].base <= addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0 || addr >= chunks[low - 1].base + chunks[low - 1].size)
+        return 0;
+    return chunks + (low - 1);
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+size_t default_alloc_template<threads, inst, SizeClasses, ChunkSource>::release_unused( )
 {
-  if (old_sz > (size_t)MAX_BYTES && new_sz > (size_t)MAX_BYTES) {
-    return realloc(p, new_sz);
+    size_t i, released = 0;
+    chunk_info *chunk;
+    obj *p;
+
+    if (threads) {
+        magazine_rack &rack = local_rack( );
+        for (i = 0; i < NCLASSES; ++i)
+            flush_magazine(rack.mags[i], i, rack.mags[i].count);
+    }
+
+    lock guard;
+    // count the free bytes of each chunk: free objects and the unused pool
+    for (i = 0; i < chunk_count; ++i)
+        chunks[i].free_bytes = 0;
+    for (i = 0; i < NCLASSES; ++i) {
+        for (p = free_list[i]; p != 0; p = p->free_list_link) {
+            if ((chunk = find_chunk(p)) != 0)
+                chunk->free_bytes += SizeClasses::class_size(i);
+        }
+    }
+    if (start_free != end_free && (chunk = find_chunk(start_free)) != 0)
+        chunk->free_bytes += end_free - start_free;
+
+    for (i = 0; i < chunk_count; ++i) {
+        if (chunks[i].free_bytes == chunks[i].size)
+            released += chunks[i].size;
+    }
+    if (0 == released)
+        return 0;
+
+    // unlink the objects living in the chunks about to be released
+    for (i = 0; i < NCLASSES; ++i) {
+        obj *volatile *link = free_list + i;
+        while ((p = *link) != 0) {
+            chunk = find_chunk(p);
+            if (chunk != 0 && chunk->free_bytes == chunk->size) {
+                *link = p->free_list_link;
+                --free_count[i];
+            } else
+                link = &p->free_list_link;
+        }
+    }
+    if (start_free != end_free) {
+        chunk = find_chunk(start_free);
+        if (chunk != 0 && chunk->free_bytes == chunk->size)
+            start_free = end_free = 0;
+    }
+
+    size_t kept = 0;
+    for (i = 0; i < chunk_count; ++i) {
+        if (chunks[i].free_bytes == chunks[i].size)
+            ChunkSource::deallocate(chunks[i].base, chunks[i].size);
+        else
+            chunks[kept++] = chunks[i];
+    }
+    chunk_count = kept;
+    heap_size -= released;
+    return released;
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::get_stats(alloc_stats &stats)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.class_count = NCLASSES;
+    for (size_t i = 0; i < NCLASSES; ++i) {
+        alloc_class_stats &cls = stats.classes[i];
+        cls.object_size = SizeClasses::class_size(i);
+#ifdef MINISTL_ALLOC_STATS
+        cls.allocations = counters.allocations[i].load(std::memory_order_relaxed);
+        cls.deallocations = counters.deallocations[i].load(std::memory_order_relaxed);
+        cls.live_objects = cls.allocations - cls.deallocations;
+#endif
+    }
+#ifdef MINISTL_ALLOC_STATS
+    stats.large_allocations = counters.large_allocations.load(std::memory_order_relaxed);
+    stats.large_deallocations = counters.large_deallocations.load(std::memory_order_relaxed);
+#endif
+
+    lock guard;
+    for (size_t i = 0; i < NCLASSES; ++i) {
+        stats.classes[i].free_bytes = free_count[i] * stats.classes[i].object_size;
+        stats.classes[i].magazine_bytes = magazine_count[i] * stats.classes[i].object_size;
+    }
+    stats.chunk_count = chunk_count;
+    stats.heap_size = heap_size;
+    stats.pool_bytes = end_free - start_free;
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void default_alloc_template<threads, inst, SizeClasses, ChunkSource>::dump_stats(FILE *out)
+{
+    alloc_stats stats;
+    get_stats(stats);
+
+    fprintf(out, "%6s %12s %12s %12s %12s %14s\n", "size", "allocs", "frees", "live", "free bytes",
+            "magazine bytes");
+    for (size_t i = 0; i < NCLASSES; ++i) {
+        const alloc_class_stats &cls = stats.classes[i];
+        fprintf(out, "%6zu %12zu %12zu %12zu %12zu %14zu\n", cls.object_size, cls.allocations,
+                cls.deallocations, cls.live_objects, cls.free_bytes, cls.magazine_bytes);
+    }
+    fprintf(out, "chunks: %zu, heap size: %zu, pool bytes: %zu\n",
+            stats.chunk_count, stats.heap_size, stats.pool_bytes);
+    fprintf(out, "large allocs: %zu, large frees: %zu\n",
+            stats.large_allocations, stats.large_deallocations);
+}
+
+template <bool threads, int inst, typename SizeClasses, typename ChunkSource>
+void* default_alloc_template<threads, inst, SizeClasses, ChunkSource>::reallocate(void* p, size_t old_sz, size_t new_sz)
+{
+  if (is_large(old_sz) && is_large(new_sz)) {
+    return large_alloc::reallocate(p, old_sz, new_sz);
   }
-  if (ROUND_UP(old_sz) == ROUND_UP(new_sz)) return p;
+  if (!is_large(old_sz) && !is_large(new_sz) && CLASS_SIZE(old_sz) == CLASS_SIZE(new_sz)) return p;
 
   void* result = allocate(new_sz);
   size_t copy_sz = new_sz > old_sz ? old_sz : new_sz;
@@ -261,9 +933,97 @@ void* default_alloc_template<threads, inst>::reallocate(void* p, size_t old_sz,
   return result;
 }
 
+// T is allocated with an alignment of Align bytes. Every allocator aligns its
+// memory to ALIGN, larger alignments are asked through the allocate_aligned
+// and deallocate_aligned functions of Alloc.
+template <typename T, typename Alloc, size_t Align = alignof(T)>
+class simple_alloc {
+private:
+    typedef typename bool_type<(Align > ALIGN)>::type over_aligned;
+
+    static void *raw_allocate(Alloc &a, size_t n, false_type) { return a.allocate(n); }
+    static void *raw_allocate(Alloc &a, size_t n, true_type) { return a.allocate_aligned(n, Align); }
+    static void raw_deallocate(Alloc &a, void *p, size_t n, false_type) { a.deallocate(p, n); }
+    static void raw_deallocate(Alloc &a, void *p, size_t n, true_type) { a.deallocate_aligned(p, n, Align); }
+
+    static void *raw_allocate(size_t n, false_type) { return Alloc::allocate(n); }
+    static void *raw_allocate(size_t n, true_type) { return Alloc::allocate_aligned(n, Align); }
+    static void raw_deallocate(void *p, size_t n, false_type) { Alloc::deallocate(p, n); }
+    static void raw_deallocate(void *p, size_t n, true_type) { Alloc::deallocate_aligned(p, n, Align); }
+
+    static void *raw_reallocate(Alloc &a, void *p, size_t old_sz, size_t new_sz, false_type)
+    {
+        return a.reallocate(p, old_sz, new_sz);
+    }
+    static void *raw_reallocate(Alloc &a, void *p, size_t old_sz, size_t new_sz, true_type)
+    {
+        return a.reallocate_aligned(p, old_sz, new_sz, Align);
+    }
+    static void *raw_reallocate(void *p, size_t old_sz, size_t new_sz, false_type)
+    {
+        return Alloc::reallocate(p, old_sz, new_sz);
+    }
+    static void *raw_reallocate(void *p, size_t old_sz, size_t new_sz, true_type)
+    {
+        return Alloc::reallocate_aligned(p, old_sz, new_sz, Align);
+    }
+
+public:
+    // allocate through the static interface of Alloc
+    static T *allocate(size_t n) { return 0 == n ? 0 : (T*)raw_allocate(n * sizeof(T), over_aligned( )); }
+    static T *allocate( ) { return (T*)raw_allocate(sizeof(T), over_aligned( )); }
+    static void deallocate(T *p, size_t n) { if (0 != n) raw_deallocate(p, n * sizeof(T), over_aligned( )); }
+    static void deallocate(T *p) { raw_deallocate(p, sizeof(T), over_aligned( )); }
+
+    // allocate from the allocator object a, which may have state
+    static T *allocate(Alloc &a, size_t n) { return 0 == n ? 0 : (T*)raw_allocate(a, n * sizeof(T), over_aligned( )); }
+    static T *allocate(Alloc &a) { return (T*)raw_allocate(a, sizeof(T), over_aligned( )); }
+    static void deallocate(Alloc &a, T *p, size_t n) { if (0 != n) raw_deallocate(a, p, n * sizeof(T), over_aligned( )); }
+    static void deallocate(Alloc &a, T *p) { raw_deallocate(a, p, sizeof(T), over_aligned( )); }
+
+    // resize the block of p from old_n to new_n objects, in place when Alloc
+    // can. The objects are moved bitwise, T must be trivially relocatable.
+    static T *reallocate(T *p, size_t old_n, size_t new_n)
+    {
+        if (0 == old_n)
+            return allocate(new_n);
+        if (0 == new_n) {
+            deallocate(p, old_n);
+            return 0;
+        }
+        return (T*)raw_reallocate(p, old_n * sizeof(T), new_n * sizeof(T), over_aligned( ));
+    }
+    static T *reallocate(Alloc &a, T *p, size_t old_n, size_t new_n)
+    {
+        if (0 == old_n)
+            return allocate(a, new_n);
+        if (0 == new_n) {
+            deallocate(a, p, old_n);
+            return 0;
+        }
+        return (T*)raw_reallocate(a, p, old_n * sizeof(T), new_n * sizeof(T), over_aligned( ));
+    }
+};
+
+// Containers derive from alloc_holder to carry an allocator object, which
+// lets them allocate from a pool handed over at construction time. An
+// allocator without state takes no space thanks to the empty base optimization.
+template <typename Alloc>
+class alloc_holder : private Alloc {
+public:
+    alloc_holder( ) { }
+    explicit alloc_holder(const Alloc &a) : Alloc(a) { }
+
+    Alloc &allocator_ref( ) { return *this; }
+    const Alloc &allocator_ref( ) const { return *this; }
+};
+
 // set the default allocator
 typedef default_alloc_template<0, 0> alloc;
 
+// allocator whose pool may be shared by several threads
+typedef default_alloc_template<true, 0> multithread_alloc;
+
 } // namespace ministl
 
 #endif // MINISTL_ALLOC_H
\ No newline at end of file
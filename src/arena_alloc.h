@@ -0,0 +1,194 @@
+#ifndef MINISTL_ARENA_ALLOC_H
+#define MINISTL_ARENA_ALLOC_H
+
+#include <cstddef>
+#include <cstring>
+#include "alloc.h"
+
+namespace ministl {
+
+// A monotonic arena bumps allocations out of blocks obtained from
+// malloc_alloc. deallocate does nothing, the memory of every allocation is
+// given back at once by release( ) or by the destructor. The block size
+// doubles each time the arena runs out of memory.
+class monotonic_arena {
+private:
+    struct block {
+        block *next;
+        size_t size;
+    };
+
+    enum { BLOCK_HEADER = (sizeof(block) + ALIGN - 1) & ~(ALIGN - 1) };
+
+public:
+    explicit monotonic_arena(size_t initial_size = 4096)
+        : blocks(0), cur(0), end(0), last_alloc(0),
+          initial_block_size(initial_size < (size_t)ALIGN ? (size_t)ALIGN : initial_size),
+          next_block_size(initial_block_size), total_size(0)
+    { }
+
+    ~monotonic_arena( ) { release( ); }
+
+    void *allocate(size_t n) { return allocate_aligned(n, ALIGN); }
+
+    void *allocate_aligned(size_t n, size_t align)
+    {
+        char *result = align_up(cur, align);
+        if (cur == 0 || result + n > end) {
+            new_block(n + align);
+            result = align_up(cur, align);
+        }
+        cur = result + n;
+        last_alloc = result;
+        return result;
+    }
+
+    void deallocate(void * /* p */, size_t /* n */) { }
+    void deallocate_aligned(void * /* p */, size_t /* n */, size_t /* align */) { }
+
+    // the most recent allocation grows in place while its block has room
+    void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+        return reallocate_aligned(p, old_sz, new_sz, ALIGN);
+    }
+
+    void *reallocate_aligned(void *p, size_t old_sz, size_t new_sz, size_t align)
+    {
+        if (p != 0 && p == last_alloc && (char *)p + new_sz <= end) {
+            cur = (char *)p + new_sz;
+            return p;
+        }
+        if (new_sz <= old_sz)
+            return p;
+        void *result = allocate_aligned(new_sz, align);
+        if (p != 0)
+            memcpy(result, p, old_sz);
+        return result;
+    }
+
+    // give every block back to malloc_alloc, the arena may be used again
+    void release( )
+    {
+        while (blocks != 0) {
+            block *next = blocks->next;
+            malloc_alloc::deallocate(blocks, blocks->size);
+            blocks = next;
+        }
+        cur = end = last_alloc = 0;
+        next_block_size = initial_block_size;
+        total_size = 0;
+    }
+
+    // number of bytes obtained from malloc_alloc
+    size_t size( ) const { return total_size; }
+
+private:
+    monotonic_arena(const monotonic_arena&);
+    monotonic_arena& operator=(const monotonic_arena&);
+
+    static char *align_up(char *p, size_t align)
+    {
+        return (char *)(((size_t)p + align - 1) & ~(align - 1));
+    }
+
+    void new_block(size_t min_size)
+    {
+        size_t size = next_block_size;
+        if (size < min_size + BLOCK_HEADER)
+            size = min_size + BLOCK_HEADER;
+        block *b = (block *)malloc_alloc::allocate(size);
+        b->next = blocks;
+        b->size = size;
+        blocks = b;
+        cur = (char *)b + BLOCK_HEADER;
+        end = (char *)b + size;
+        next_block_size = 2 * next_block_size;
+        total_size += size;
+    }
+
+private:
+    block *blocks;
+    char *cur;
+    char *end;
+    char *last_alloc;
+    size_t initial_block_size;
+    size_t next_block_size;
+    size_t total_size;
+};
+
+// a copyable handle to a monotonic_arena, usable as the Alloc parameter of
+// the containers constructed with it, e.g.
+//   monotonic_arena arena;
+//   vector<int, arena_ref> v((arena_ref(arena)));
+class arena_ref {
+public:
+    arena_ref(monotonic_arena &a) : arena(&a) { }
+
+    void *allocate(size_t n) { return arena->allocate(n); }
+    void deallocate(void *p, size_t n) { arena->deallocate(p, n); }
+    void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+        return arena->reallocate(p, old_sz, new_sz);
+    }
+
+    void *allocate_aligned(size_t n, size_t align) { return arena->allocate_aligned(n, align); }
+    void deallocate_aligned(void *p, size_t n, size_t align) { arena->deallocate_aligned(p, n, align); }
+    void *reallocate_aligned(void *p, size_t old_sz, size_t new_sz, size_t align)
+    {
+        return arena->reallocate_aligned(p, old_sz, new_sz, align);
+    }
+
+    static size_t good_size(size_t n) { return (n + ALIGN - 1) & ~size_t(ALIGN - 1); }
+
+    monotonic_arena &resource( ) const { return *arena; }
+
+    bool operator==(const arena_ref &rhs) const { return arena == rhs.arena; }
+    bool operator!=(const arena_ref &rhs) const { return arena != rhs.arena; }
+
+private:
+    monotonic_arena *arena;
+};
+
+// the arena allocator with the static interface taken by the Alloc parameter
+// of the containers. Every instantiation owns one arena shared by all of its
+// users, it is not thread safe: give each thread its own inst.
+template <int inst>
+class arena_alloc_template {
+private:
+    static monotonic_arena &arena( )
+    {
+        static monotonic_arena instance;
+        return instance;
+    }
+
+public:
+    static void *allocate(size_t n) { return arena( ).allocate(n); }
+    static void deallocate(void *p, size_t n) { arena( ).deallocate(p, n); }
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+        return arena( ).reallocate(p, old_sz, new_sz);
+    }
+
+    static void *allocate_aligned(size_t n, size_t align) { return arena( ).allocate_aligned(n, align); }
+    static void deallocate_aligned(void *p, size_t n, size_t align)
+    {
+        arena( ).deallocate_aligned(p, n, align);
+    }
+    static void *reallocate_aligned(void *p, size_t old_sz, size_t new_sz, size_t align)
+    {
+        return arena( ).reallocate_aligned(p, old_sz, new_sz, align);
+    }
+
+    static size_t good_size(size_t n) { return (n + ALIGN - 1) & ~size_t(ALIGN - 1); }
+
+    // free the memory of every object allocated so far, containers using the
+    // allocator must not be touched afterwards
+    static void release( ) { arena( ).release( ); }
+    static size_t size( ) { return arena( ).size( ); }
+};
+
+typedef arena_alloc_template<0> arena_alloc;
+
+} // namespace ministl
+
+#endif // MINISTL_ARENA_ALLOC_H
@@ -2,13 +2,14 @@
 #define MINISTL_CONSTRUCT_H
 
 #include <new.h>
+#include <utility>
 #include "iterator.h"
 #include "type_traits.h"
 
 namespace ministl {
 
-template <class T1, class T2>
-inline void construct(T1 *p, const T2 &value) { new ((void*)p) T1(value); }
+template <class T1, class... Args>
+inline void construct(T1 *p, Args&&... args) { new ((void*)p) T1(std::forward<Args>(args)...); }
 
 template <typename T>
 inline void destory(T* pointer) { pointer->~T( ); }
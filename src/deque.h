@@ -160,7 +160,7 @@ struct DequeIterator {
 
 
 template <typename T, typename Alloc = alloc, size_t BufSize = 0>
-class deque {
+class deque : protected alloc_holder<Alloc> {
 public:
   typedef T                  value_type;
   typedef value_type*        pointer;
@@ -169,6 +169,7 @@ public:
   typedef const value_type&  const_reference;
   typedef size_t             size_type;
   typedef ptrdiff_t          difference_type;
+  typedef Alloc              allocator_type;
 
 public:
   typedef DequeIterator<T, T&, T*, BufSize> iterator;
@@ -188,13 +189,18 @@ public:
     initialize_map(0);
   }
 
-  deque(size_t n)
+  explicit deque(const Alloc& a) : alloc_holder<Alloc>(a)
+  {
+    initialize_map(0);
+  }
+
+  deque(size_t n, const Alloc& a = Alloc( )) : alloc_holder<Alloc>(a)
   {
     initialize_map(n);
     fill_initialize(value_type( ));
   }
 
-  deque(size_t n, const value_type& value)
+  deque(size_t n, const value_type& value, const Alloc& a = Alloc( )) : alloc_holder<Alloc>(a)
   {
     initialize_map(n);
     fill_initialize(value);
@@ -207,6 +213,8 @@ public:
     }
   }
 
+  allocator_type get_allocator( ) const { return this->allocator_ref( ); }
+
   iterator begin( ) { return start; }
   iterator end( ) { return finish; }
   const_iterator begin( ) const { return start; }
@@ -305,13 +313,13 @@ public:
   {
     for (map_pointer cur_node = start.node + 1; cur_node < finish.node; ++cur_node) {
       destory(*cur_node, *cur_node + SBufferSize( ));
-      data_allocator::deallocate(*cur_node, SBufferSize( ));
+      deallocate_node(*cur_node);
     }
 
     if (start.node != finish.node) {
       destory(start.cur, start.last);
       destory(finish.first, finish.cur);
-      data_allocator::deallocate(finish.first, SBufferSize( ));
+      deallocate_node(finish.first);
     } else {
       destory(start.cur, finish.cur);
     }
@@ -327,16 +335,24 @@ protected:
   void pop_front_aux( );
   void pop_back_aux( );
   iterator insert_aux(iterator pos, const value_type& value);
-  pointer allocate_node( ) { return data_allocator::allocate(DequeBufSize(sizeof(T))); }
-  void deallocate_node(pointer p) { data_allocator::deallocate(p, DequeBufSize(sizeof(T))); }
+  pointer allocate_node( )
+  {
+    return data_allocator::allocate(this->allocator_ref( ), DequeBufSize(sizeof(T)));
+  }
+
+  void deallocate_node(pointer p)
+  {
+    data_allocator::deallocate(this->allocator_ref( ), p, DequeBufSize(sizeof(T)));
+  }
+
   map_pointer allocate_map(size_t n)
   {
-    return map_allocator::allocate(n);
+    return map_allocator::allocate(this->allocator_ref( ), n);
   }
 
   void deallocate_map(map_pointer p, size_t n)
   {
-    map_allocator::deallocate(p, n);
+    map_allocator::deallocate(this->allocator_ref( ), p, n);
   }
   void initialize_map(size_t num_elements);
   void create_nodes(map_pointer nstart, map_pointer nfinish);
@@ -471,7 +487,7 @@ void deque<Tp, Alloc, BufSize>::initialize_map(size_t num_elements)
 {
   size_type num_nodes = num_elements / SBufferSize() + 1;
   map_size = max(size_type(InitialMapSize), size_type(num_nodes + 2));
-  map = map_allocator::allocate(map_size);
+  map = allocate_map(map_size);
   map_pointer nstart = map + (map_size - num_nodes) / 2;
   map_pointer nfinish = nstart + num_nodes;
 
@@ -521,7 +537,7 @@ void deque<Tp, Alloc, BufSize>::reallocate_map(size_type nodes_to_add, bool add_
     size_type new_map_size = map_size + max(map_size, nodes_to_add) + 2;
     map_pointer new_map = allocate_map(new_map_size);
     new_nstart = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
-    ministl::copy(start.node, finish.node + 1, new_nstart);
+    ministl::uninitialized_relocate(start.node, finish.node + 1, new_nstart);
     deallocate_map(map, map_size);
     map = new_map;
     map_size = new_map_size;
@@ -0,0 +1,427 @@
+#ifndef MINISTL_EXECUTION_H
+#define MINISTL_EXECUTION_H
+
+#include <stddef.h>
+#include <atomic>
+#include <type_traits>
+#include "algorithm.h"
+#include "alloc.h"
+#include "construct.h"
+#include "functools.h"
+#include "numeric.h"
+#include "thread_pool.h"
+
+namespace ministl {
+
+//------------------------------------------------------------------------------
+// execution policies
+//------------------------------------------------------------------------------
+// The overloads taking a policy first run over random access ranges on the
+// chunks of thread_pool::default_pool( ) with par and par_unseq, and like the
+// overloads without a policy with seq or other iterators. The functions given
+// to a parallel algorithm are called concurrently from several threads and
+// the operations of accumulate and inner_product must be associative.
+//------------------------------------------------------------------------------
+namespace execution {
+
+struct sequenced_policy { };
+struct parallel_policy { };
+struct parallel_unsequenced_policy { };
+
+const sequenced_policy seq = sequenced_policy( );
+const parallel_policy par = parallel_policy( );
+const parallel_unsequenced_policy par_unseq = parallel_unsequenced_policy( );
+
+} // namespace execution
+
+template <typename T>
+struct is_execution_policy {
+  static const bool value = false;
+};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> {
+  static const bool value = true;
+};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> {
+  static const bool value = true;
+};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> {
+  static const bool value = true;
+};
+
+// type is R for execution policies, which keeps the overloads below out of
+// the way of the ones without a policy
+template <typename ExecutionPolicy, typename R>
+struct __enable_policy
+  : std::enable_if<is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, R> { };
+
+// type is true_type when the policy and the iterators allow running on the pool
+template <typename ExecutionPolicy, typename Iterator1, typename Iterator2 = Iterator1>
+struct __runs_parallel {
+  typedef typename std::decay<ExecutionPolicy>::type policy;
+  static const bool value =
+    !std::is_same<policy, execution::sequenced_policy>::value &&
+    std::is_same<typename iterator_traits<Iterator1>::iterator_category,
+                 random_access_iterator_tag>::value &&
+    std::is_same<typename iterator_traits<Iterator2>::iterator_category,
+                 random_access_iterator_tag>::value;
+  typedef typename bool_type<value>::type type;
+};
+
+// chunks smaller than this are not worth a task
+enum { PARALLEL_MIN_CHUNK = 4096 };
+
+// the split of [0, n) into chunks of nearly equal sizes, about four for each
+// thread of the pool so that stealing evens out their speeds
+struct __chunk_plan {
+  explicit __chunk_plan(size_t n) : n(n)
+  {
+    chunks = thread_pool::default_pool( ).concurrency( ) * 4;
+    if (n / chunks < PARALLEL_MIN_CHUNK)
+      chunks = n / PARALLEL_MIN_CHUNK;
+    if (chunks == 0)
+      chunks = 1;
+  }
+
+  size_t begin(size_t c) const { return n / chunks * c + (c < n % chunks ? c : n % chunks); }
+  size_t end(size_t c) const { return begin(c + 1); }
+
+  size_t n;
+  size_t chunks;
+};
+
+// run body(begin, end) over the chunks of plan
+template <typename Body>
+struct __chunk_task {
+  void operator()(size_t c) const { body(plan.begin(c), plan.end(c)); }
+
+  const __chunk_plan& plan;
+  const Body& body;
+};
+
+template <typename Body>
+inline void __parallel_chunks(const __chunk_plan& plan, const Body& body)
+{
+  if (plan.chunks == 1) {
+    body(0, plan.n);
+    return;
+  }
+  __chunk_task<Body> task = { plan, body };
+  thread_pool::default_pool( ).parallel_chunks(plan.chunks, task);
+}
+
+// fold the results of reduce(begin, end) for the chunks of [0, n), n > 0,
+// into init with combine, in the order of the chunks
+template <typename T, typename Reduce, typename Combine>
+T __parallel_reduce(size_t n, T init, const Reduce& reduce, Combine combine)
+{
+  typedef simple_alloc<T, alloc> result_allocator;
+  typedef simple_alloc<unsigned char, alloc> flag_allocator;
+
+  const __chunk_plan plan(n);
+  T* results = result_allocator::allocate(plan.chunks);
+  unsigned char* built = flag_allocator::allocate(plan.chunks);
+  memset(built, 0, plan.chunks);
+  auto chunk = [&](size_t c) {
+    construct(results + c, reduce(plan.begin(c), plan.end(c)));
+    built[c] = 1;
+  };
+  try {
+    if (plan.chunks == 1)
+      chunk(0);
+    else
+      thread_pool::default_pool( ).parallel_chunks(plan.chunks, chunk);
+    for (size_t c = 0; c < plan.chunks; ++c)
+      init = combine(init, results[c]);
+  } catch (...) {
+    for (size_t c = 0; c < plan.chunks; ++c) {
+      if (built[c])
+        destory(results + c);
+    }
+    flag_allocator::deallocate(built, plan.chunks);
+    result_allocator::deallocate(results, plan.chunks);
+    throw;
+  }
+  destory(results, results + plan.chunks);
+  flag_allocator::deallocate(built, plan.chunks);
+  result_allocator::deallocate(results, plan.chunks);
+  return init;
+}
+
+//------------------------------------------------------------------------------
+// names of algorithms: for_each, map, fill, copy, generate
+//------------------------------------------------------------------------------
+template <typename RandomAccessIterator, typename Operation>
+inline void __for_each(RandomAccessIterator first, RandomAccessIterator last, Operation op,
+                       true_type)
+{
+  __parallel_chunks(__chunk_plan(last - first), [&](size_t begin, size_t end) {
+    ministl::for_each(first + begin, first + end, op);
+  });
+}
+
+template <typename InputIterator, typename Operation>
+inline void __for_each(InputIterator first, InputIterator last, Operation op, false_type)
+{
+  ministl::for_each(first, last, op);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Operation>
+inline typename __enable_policy<ExecutionPolicy, void>::type
+for_each(ExecutionPolicy&&, InputIterator first, InputIterator last, Operation op)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator>::type parallel;
+  ministl::__for_each(first, last, op, parallel( ));
+}
+
+template <typename ExecutionPolicy, typename ForwardIterator, typename Operation>
+inline typename __enable_policy<ExecutionPolicy, void>::type
+map(ExecutionPolicy&&, ForwardIterator first, ForwardIterator last, Operation op)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, ForwardIterator>::type parallel;
+  typedef typename iterator_traits<ForwardIterator>::value_type value_type;
+  ministl::__for_each(first, last, [&](value_type& x) { x = op(x); }, parallel( ));
+}
+
+template <typename ExecutionPolicy, typename ForwardIterator, typename Generator>
+inline typename __enable_policy<ExecutionPolicy, void>::type
+generate(ExecutionPolicy&&, ForwardIterator first, ForwardIterator last, Generator gen)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, ForwardIterator>::type parallel;
+  typedef typename iterator_traits<ForwardIterator>::value_type value_type;
+  ministl::__for_each(first, last, [&](value_type& x) { x = gen( ); }, parallel( ));
+}
+
+// the chunks of pointer ranges keep the vectorized fill
+template <typename RandomAccessIterator, typename T>
+inline void __fill(RandomAccessIterator first, RandomAccessIterator last, const T& value,
+                   true_type)
+{
+  __parallel_chunks(__chunk_plan(last - first), [&](size_t begin, size_t end) {
+    ministl::fill(first + begin, first + end, value);
+  });
+}
+
+template <typename ForwardIterator, typename T>
+inline void __fill(ForwardIterator first, ForwardIterator last, const T& value, false_type)
+{
+  ministl::fill(first, last, value);
+}
+
+template <typename ExecutionPolicy, typename ForwardIterator, typename T>
+inline typename __enable_policy<ExecutionPolicy, void>::type
+fill(ExecutionPolicy&&, ForwardIterator first, ForwardIterator last, const T& value)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, ForwardIterator>::type parallel;
+  ministl::__fill(first, last, value, parallel( ));
+}
+
+template <typename RandomAccessIterator, typename OutputIterator>
+inline OutputIterator __copy(RandomAccessIterator first, RandomAccessIterator last,
+                             OutputIterator result, true_type)
+{
+  __parallel_chunks(__chunk_plan(last - first), [&](size_t begin, size_t end) {
+    ministl::copy(first + begin, first + end, result + begin);
+  });
+  return result + (last - first);
+}
+
+template <typename InputIterator, typename OutputIterator>
+inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result,
+                             false_type)
+{
+  return ministl::copy(first, last, result);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename OutputIterator>
+inline typename __enable_policy<ExecutionPolicy, OutputIterator>::type
+copy(ExecutionPolicy&&, InputIterator first, InputIterator last, OutputIterator result)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator, OutputIterator>::type parallel;
+  return ministl::__copy(first, last, result, parallel( ));
+}
+
+//------------------------------------------------------------------------------
+// names of algorithms: find_if, count_if, all_of, any_of, none_of
+//------------------------------------------------------------------------------
+// the chunks after the leftmost match found so far are skipped
+template <typename RandomAccessIterator, typename Predicate>
+RandomAccessIterator __find_if(RandomAccessIterator first, RandomAccessIterator last,
+                               Predicate pred, true_type)
+{
+  const size_t n = last - first;
+  std::atomic<size_t> found(n);
+  __parallel_chunks(__chunk_plan(n), [&](size_t begin, size_t end) {
+    if (begin >= found.load(std::memory_order_relaxed))
+      return;
+    size_t i = ministl::find_if(first + begin, first + end, pred) - first;
+    if (i == end)
+      return;
+    size_t current = found.load( );
+    while (i < current && !found.compare_exchange_weak(current, i)) { }
+  });
+  return first + found.load( );
+}
+
+template <typename InputIterator, typename Predicate>
+inline InputIterator __find_if(InputIterator first, InputIterator last, Predicate pred,
+                               false_type)
+{
+  return ministl::find_if(first, last, pred);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Predicate>
+inline typename __enable_policy<ExecutionPolicy, InputIterator>::type
+find_if(ExecutionPolicy&&, InputIterator first, InputIterator last, Predicate pred)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator>::type parallel;
+  return ministl::__find_if(first, last, pred, parallel( ));
+}
+
+template <typename RandomAccessIterator, typename Predicate>
+typename iterator_traits<RandomAccessIterator>::difference_type
+__count_if(RandomAccessIterator first, RandomAccessIterator last, Predicate pred, true_type)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+  std::atomic<difference_type> n(0);
+  __parallel_chunks(__chunk_plan(last - first), [&](size_t begin, size_t end) {
+    n.fetch_add(ministl::count_if(first + begin, first + end, pred), std::memory_order_relaxed);
+  });
+  return n.load( );
+}
+
+template <typename InputIterator, typename Predicate>
+inline typename iterator_traits<InputIterator>::difference_type
+__count_if(InputIterator first, InputIterator last, Predicate pred, false_type)
+{
+  return ministl::count_if(first, last, pred);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Predicate>
+inline typename __enable_policy<ExecutionPolicy,
+                                typename iterator_traits<InputIterator>::difference_type>::type
+count_if(ExecutionPolicy&&, InputIterator first, InputIterator last, Predicate pred)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator>::type parallel;
+  return ministl::__count_if(first, last, pred, parallel( ));
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Predicate>
+inline typename __enable_policy<ExecutionPolicy, bool>::type
+any_of(ExecutionPolicy&& policy, InputIterator first, InputIterator last, Predicate pred)
+{
+  return ministl::find_if(policy, first, last, pred) != last;
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Predicate>
+inline typename __enable_policy<ExecutionPolicy, bool>::type
+none_of(ExecutionPolicy&& policy, InputIterator first, InputIterator last, Predicate pred)
+{
+  return !ministl::any_of(policy, first, last, pred);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename Predicate>
+inline typename __enable_policy<ExecutionPolicy, bool>::type
+all_of(ExecutionPolicy&& policy, InputIterator first, InputIterator last, Predicate pred)
+{
+  typedef typename iterator_traits<InputIterator>::value_type value_type;
+  return !ministl::any_of(policy, first, last, [&](const value_type& x) { return !pred(x); });
+}
+
+//------------------------------------------------------------------------------
+// names of algorithms: accumulate, inner_product
+//------------------------------------------------------------------------------
+// each chunk is folded starting from its first element, so the value type
+// must convert to T
+template <typename RandomAccessIterator, typename T, typename BinaryOperation>
+T __accumulate(RandomAccessIterator first, RandomAccessIterator last, T init,
+               BinaryOperation binary_op, true_type)
+{
+  if (first == last)
+    return init;
+  return __parallel_reduce(last - first, init, [&](size_t begin, size_t end) {
+    T partial = *(first + begin);
+    return ministl::accumulate(first + begin + 1, first + end, partial, binary_op);
+  }, binary_op);
+}
+
+template <typename InputIterator, typename T, typename BinaryOperation>
+inline T __accumulate(InputIterator first, InputIterator last, T init,
+                      BinaryOperation binary_op, false_type)
+{
+  return ministl::accumulate(first, last, init, binary_op);
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename T, typename BinaryOperation>
+inline typename __enable_policy<ExecutionPolicy, T>::type
+accumulate(ExecutionPolicy&&, InputIterator first, InputIterator last, T init,
+           BinaryOperation binary_op)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator>::type parallel;
+  return ministl::__accumulate(first, last, init, binary_op, parallel( ));
+}
+
+template <typename ExecutionPolicy, typename InputIterator, typename T>
+inline typename __enable_policy<ExecutionPolicy, T>::type
+accumulate(ExecutionPolicy&& policy, InputIterator first, InputIterator last, T init)
+{
+  return ministl::accumulate(policy, first, last, init,
+                             [](const T& a, const T& b) { return a + b; });
+}
+
+template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename T,
+          typename BinaryOperation1, typename BinaryOperation2>
+T __inner_product(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+                  RandomAccessIterator2 first2, T init,
+                  BinaryOperation1 binary_op1, BinaryOperation2 binary_op2, true_type)
+{
+  if (first1 == last1)
+    return init;
+  return __parallel_reduce(last1 - first1, init, [&](size_t begin, size_t end) {
+    T partial = binary_op2(*(first1 + begin), *(first2 + begin));
+    return ministl::inner_product(first1 + begin + 1, first1 + end, first2 + begin + 1, partial,
+                                  binary_op1, binary_op2);
+  }, binary_op1);
+}
+
+template <typename InputIterator1, typename InputIterator2, typename T,
+          typename BinaryOperation1, typename BinaryOperation2>
+inline T __inner_product(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2,
+                         T init, BinaryOperation1 binary_op1, BinaryOperation2 binary_op2,
+                         false_type)
+{
+  return ministl::inner_product(first1, last1, first2, init, binary_op1, binary_op2);
+}
+
+template <typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename T,
+          typename BinaryOperation1, typename BinaryOperation2>
+inline typename __enable_policy<ExecutionPolicy, T>::type
+inner_product(ExecutionPolicy&&, InputIterator1 first1, InputIterator1 last1,
+              InputIterator2 first2, T init,
+              BinaryOperation1 binary_op1, BinaryOperation2 binary_op2)
+{
+  typedef typename __runs_parallel<ExecutionPolicy, InputIterator1, InputIterator2>::type parallel;
+  return ministl::__inner_product(first1, last1, first2, init, binary_op1, binary_op2,
+                                  parallel( ));
+}
+
+template <typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename T>
+inline typename __enable_policy<ExecutionPolicy, T>::type
+inner_product(ExecutionPolicy&& policy, InputIterator1 first1, InputIterator1 last1,
+              InputIterator2 first2, T init)
+{
+  typedef typename iterator_traits<InputIterator1>::value_type value_type1;
+  typedef typename iterator_traits<InputIterator2>::value_type value_type2;
+  return ministl::inner_product(policy, first1, last1, first2, init,
+                                [](const T& a, const T& b) { return a + b; },
+                                [](const value_type1& a, const value_type2& b) { return a * b; });
+}
+
+} // namespace ministl
+
+#endif // MINISTL_EXECUTION_H
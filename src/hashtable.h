@@ -1,7 +1,7 @@
 #ifndef HASHTABLE_H
 #define HASHTABLE_H
 #include "alloc.h"
-#include <vector>
+#include "vector.h"
 #include <algorithm>
 
 namespace ministl {
@@ -134,12 +134,13 @@ bool operator==(const hashtable<Value, Key, HashFunc, ExtractKey, EqualKey, Allo
 
 
 template <typename Value, typename Key, typename HashFunc, typename ExtractKey, typename EqualKey, typename Alloc = alloc>
-class hashtable {
+class hashtable : protected alloc_holder<Alloc> {
 public:
   using key_type = Key;
   using value_type = Value;
   using hasher = HashFunc;
   using key_equal = EqualKey;
+  using allocator_type = Alloc;
 
   using size_type = size_t;
   using difference_type = ptrdiff_t;
@@ -157,6 +158,7 @@ public:
 public:
   hasher hash_funct( ) const { return hash_; }
   key_equal key_eq( ) const { return equals_; }
+  allocator_type get_allocator( ) const { return this->allocator_ref( ); }
 
 private:
   using node = hashtable_node<Value>;
@@ -167,17 +169,18 @@ public:
 private:
   node* get_node( )
   {
-    return node_allocator::allocate(1);
+    return node_allocator::allocate(this->allocator_ref( ), 1);
   }
 
-  node* put_node(node* p)
+  void put_node(node* p)
   {
-    node_allocator::deallocate(p, 1);
+    node_allocator::deallocate(this->allocator_ref( ), p, 1);
   }
 
 public:
-  hashtable(size_type n, const HashFunc& hf, const EqualKey& eql)
-    : hash_(hf), equals_(eql), get_key_(ExtractKey( )), num_elements_(0)
+  hashtable(size_type n, const HashFunc& hf, const EqualKey& eql, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a), hash_(hf), equals_(eql), get_key_(ExtractKey( )),
+      buckets_(this->allocator_ref( )), num_elements_(0)
   {
     initialize_buckets(n);
   }
@@ -200,8 +203,10 @@ public:
   size_type max_size( ) const { return size_type(-1); }
   bool empty( ) const { return size( ) == 0; }
 
+  // the allocators are swapped with the nodes they allocated
   void swap(hashtable& ht)
   {
+    std::swap(this->allocator_ref( ), ht.allocator_ref( ));
     std::swap(hash_, ht.hash_);
     std::swap(equals_, ht.equals_);
     std::swap(get_key_, ht.get_key_);
@@ -246,7 +251,7 @@ public:
     if (num_elements_hint > old_n) {
       const size_type n = next_size(num_elements_hint);
       if (n > old_n) {
-        std::vector<node*, Alloc> tmp(n, (node*)0);
+        vector<node*, Alloc> tmp(n, (node*)0, this->allocator_ref( ));
         try {
           for (size_type bucket = 0; bucket < old_n; ++bucket) {
             node* first = buckets_[bucket];
@@ -259,6 +264,15 @@ public:
             }
           }
           buckets_.swap(tmp);
+        } catch (...) {
+          for (size_type bucket = 0; bucket < tmp.size( ); ++bucket) {
+            while (tmp[bucket]) {
+              node* next = tmp[bucket]->next;
+              delete_node(tmp[bucket]);
+              tmp[bucket] = next;
+            }
+          }
+          throw;
         }
       }
     }
@@ -340,8 +354,8 @@ public:
   void copy_from(const hashtable& ht)
   {
     buckets_.clear( );
-    buckets_.resize(ht.buckets_.size( ));
-    buckets_.insert(buckets_.end( ), ht.buckets_.size( ); (node*)0);
+    buckets_.reserve(ht.buckets_.size( ));
+    buckets_.insert(buckets_.end( ), ht.buckets_.size( ), (node*)0);
     try {
       for (size_type i = 0; i < ht.buckets_.size( ); ++i) {
         if (const node* cur = ht.buckets_[i]) {
@@ -417,7 +431,8 @@ private:
   key_equal equals_;
   ExtractKey get_key_;
 
-  std::vector<node*, Alloc> buckets_;
+  // the bucket array comes from the allocator of the table too
+  vector<node*, Alloc> buckets_;
   size_type num_elements_;
 };
 
@@ -135,7 +135,7 @@ void adjust_heap(RandomAccessIterator first, Distance hole_index, Distance len,
     *(first + hole_index) = *(first + (second_child - 1));
     hole_index = second_child - 1;
   }
-  do_push_heap(first, hole_index, top_index, value);
+  do_push_heap(first, hole_index, top_index, value, comp);
 }
 
 
@@ -71,7 +71,7 @@ struct list_iterator {
 };
 
 template <typename T, typename Alloc = alloc>
-class list {
+class list : protected alloc_holder<Alloc> {
 protected:
     typedef list_node<T> list_node;
     typedef simple_alloc<list_node, Alloc> list_node_allocator;
@@ -86,11 +86,12 @@ public:
     typedef list_node*                link_type;
     typedef list_iterator<T, T&, T*>  iterator;
     typedef list_iterator<T, const T&, const T*> const_iterator;
+    typedef Alloc                     allocator_type;
 protected:
     link_type node;
 protected:
-    link_type get_node( )      { return list_node_allocator::allocate( ); }
-    void put_node(link_type p) { list_node_allocator::deallocate(p);      }
+    link_type get_node( )      { return list_node_allocator::allocate(this->allocator_ref( )); }
+    void put_node(link_type p) { list_node_allocator::deallocate(this->allocator_ref( ), p); }
     link_type create_node(const T& x) 
     {
         link_type p = get_node( );
@@ -120,6 +121,8 @@ protected:
 
 public:
     list( ) { empty_initialize( ); }
+    explicit list(const Alloc& a) : alloc_holder<Alloc>(a) { empty_initialize( ); }
+    allocator_type get_allocator( ) const { return this->allocator_ref( ); }
     iterator  begin( ) { return (link_type)((*node).next); }
     iterator  end( )   { return node;       }
     iterator  begin() const { return (link_type)((*node).next); }
@@ -178,7 +181,7 @@ void list<T, Alloc>::clear( )
     while (cur != node) {
         link_type tmp = cur;
         cur = (link_type)cur->next;
-        list_node_allocator::deallocate(tmp);
+        put_node(tmp);
     }
     node->next = node;
     node->prev = node;
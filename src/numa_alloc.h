@@ -0,0 +1,440 @@
+#ifndef MINISTL_NUMA_ALLOC_H
+#define MINISTL_NUMA_ALLOC_H
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include "alloc.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ministl {
+
+enum { NUMA_MAX_NODES = 64 };
+enum { NUMA_INST_BASE = 1 << 24 };
+// the chunks of the node pools are aligned to regions of this many bytes
+enum { NUMA_REGION_SHIFT = 16 };
+enum { NUMA_REGION_SIZE = 1 << NUMA_REGION_SHIFT };
+
+struct numa_node_stats {
+    alloc_stats pool;
+    // the counters are only maintained when MINISTL_ALLOC_STATS is defined,
+    // blocks larger than the largest size class are not counted
+    size_t allocations;
+    size_t deallocations;
+    size_t remote_deallocations;  // objects freed by a thread of another node
+};
+
+// The node of every chunk of the node pools, read without a lock when an
+// object is freed. A chunk owns all the regions it covers and the byte kept
+// for a region is the node of its chunk plus one, or 0. The leaves of the
+// two level table are allocated on first use and never freed. Regions past
+// the first 2^48 bytes of the address space are not recorded.
+template <int dummy>
+class numa_region_map_template {
+private:
+    enum { LEAF_BITS = 16 };
+    enum { ROOT_BITS = 48 - NUMA_REGION_SHIFT - LEAF_BITS };
+    enum { LEAF_SIZE = 1 << LEAF_BITS };
+
+    typedef std::atomic<unsigned char> entry;
+    static std::atomic<entry *> root[1 << ROOT_BITS];
+
+    static bool in_range(size_t region) { return (region >> LEAF_BITS) < ((size_t)1 << ROOT_BITS); }
+
+    static entry *leaf(size_t region, bool create)
+    {
+        std::atomic<entry *> &slot = root[region >> LEAF_BITS];
+        entry *result = slot.load(std::memory_order_acquire);
+        if (result != 0 || !create)
+            return result;
+        entry *fresh = new (std::nothrow) entry[LEAF_SIZE];
+        if (fresh == 0)
+            return 0;
+        for (size_t i = 0; i < (size_t)LEAF_SIZE; ++i)
+            fresh[i].store(0, std::memory_order_relaxed);
+        if (slot.compare_exchange_strong(result, fresh, std::memory_order_acq_rel))
+            return fresh;
+        delete[] fresh;
+        return result;
+    }
+
+public:
+    // record value for every region of [p, p + n), false when out of memory
+    static bool set(const void *p, size_t n, unsigned char value)
+    {
+        const size_t first = (size_t)p >> NUMA_REGION_SHIFT;
+        const size_t last = ((size_t)p + n - 1) >> NUMA_REGION_SHIFT;
+        for (size_t region = first; region <= last && in_range(region); ++region) {
+            entry *e = leaf(region, value != 0);
+            if (e == 0) {
+                if (value != 0)
+                    return false;
+                continue;
+            }
+            e[region & (LEAF_SIZE - 1)].store(value, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // the value recorded for the region of p, 0 if there is none
+    static unsigned char get(const void *p)
+    {
+        const size_t region = (size_t)p >> NUMA_REGION_SHIFT;
+        if (!in_range(region))
+            return 0;
+        entry *e = root[region >> LEAF_BITS].load(std::memory_order_acquire);
+        return e == 0 ? 0 : e[region & (LEAF_SIZE - 1)].load(std::memory_order_acquire);
+    }
+};
+
+template <int dummy>
+std::atomic<typename numa_region_map_template<dummy>::entry *>
+    numa_region_map_template<dummy>::root[1 << ROOT_BITS];
+
+typedef numa_region_map_template<0> numa_region_map;
+
+// Gives the chunks of ChunkSource aligned to NUMA_REGION_SIZE. A chunk source
+// whose chunk_granularity is a multiple of the region size must return
+// aligned chunks already, as huge_page_chunk_source does. The chunks of
+// other sources are allocated one region larger and the block really
+// allocated is kept in front of the aligned chunk.
+template <typename ChunkSource>
+struct numa_region_chunk_source {
+    enum { aligned = ChunkSource::chunk_granularity % NUMA_REGION_SIZE == 0 };
+    enum { chunk_granularity = aligned ? (int)ChunkSource::chunk_granularity : (int)NUMA_REGION_SIZE };
+
+    static size_t good_size(size_t n) { return aligned ? ChunkSource::good_size(n) : n; }
+
+    static void *allocate(size_t n)
+    {
+        if (aligned)
+            return ChunkSource::allocate(n);
+        char *raw = (char *)ChunkSource::allocate(n + NUMA_REGION_SIZE);
+        if (raw == 0)
+            return 0;
+        char *result = (char *)(((size_t)raw + NUMA_REGION_SIZE) & ~size_t(NUMA_REGION_SIZE - 1));
+        ((void **)result)[-1] = raw;
+        return result;
+    }
+
+    static void deallocate(void *p, size_t n)
+    {
+        if (aligned)
+            ChunkSource::deallocate(p, n);
+        else
+            ChunkSource::deallocate(((void **)p)[-1], n + NUMA_REGION_SIZE);
+    }
+
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+        void *result = allocate(new_sz);
+        if (result != 0) {
+            memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+            deallocate(p, old_sz);
+        }
+        return result;
+    }
+};
+
+// A pooled allocator with one default_alloc_template pool per NUMA node. A
+// thread allocates from the pool of the node it runs on, so the chunks of a
+// pool are carved, and first touched, by threads of its node. An object is
+// always given back to the pool of the node which allocated it.
+//
+// The node of the calling thread comes from getcpu( ) on Linux and is node 0
+// elsewhere. set_simulated_nodes(n) spreads the cpus over n nodes instead,
+// which allows testing on a single node machine, and bind_thread_to_node
+// pins the calling thread to a node.
+//
+// The chunks of the pools are aligned to regions and numa_region_map records
+// the node of each region, so deallocate finds the pool of an object without
+// taking a lock.
+template <int inst, int MaxNodes = 8, typename SizeClasses = sgi_size_classes,
+          typename ChunkSource = malloc_chunk_source>
+class numa_alloc_template {
+private:
+    static_assert(MaxNodes > 0 && MaxNodes <= NUMA_MAX_NODES, "unsupported number of nodes");
+
+    // the chunks of the pool of node, which mark their regions as owned by
+    // node while they are allocated
+    template <int node>
+    struct node_chunk_source {
+        typedef numa_region_chunk_source<ChunkSource> source;
+        enum { chunk_granularity = source::chunk_granularity };
+
+        static size_t good_size(size_t n) { return source::good_size(n); }
+
+        static void *allocate(size_t n)
+        {
+            void *result = source::allocate(n);
+            if (result != 0 && !numa_region_map::set(result, n, (unsigned char)(node + 1))) {
+                source::deallocate(result, n);
+                return 0;
+            }
+            return result;
+        }
+
+        static void deallocate(void *p, size_t n)
+        {
+            numa_region_map::set(p, n, 0);
+            source::deallocate(p, n);
+        }
+
+        static void *reallocate(void *p, size_t old_sz, size_t new_sz)
+        {
+            void *result = allocate(new_sz);
+            if (result != 0) {
+                memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+                deallocate(p, old_sz);
+            }
+            return result;
+        }
+    };
+
+    template <int node>
+    struct node_pool {
+        typedef default_alloc_template<true, NUMA_INST_BASE + inst * NUMA_MAX_NODES + node,
+                                       SizeClasses, node_chunk_source<node> > type;
+    };
+
+    struct pool_ops {
+        void *(*allocate)(size_t);
+        void (*deallocate)(void *, size_t);
+        bool (*chunk_of)(const void *, const char *&, size_t &);
+        size_t (*release_unused)( );
+        void (*get_stats)(alloc_stats &);
+    };
+
+    template <int nodes, int dummy = 0>
+    struct ops_filler {
+        static void fill(pool_ops *ops)
+        {
+            typedef typename node_pool<nodes - 1>::type pool;
+            ops_filler<nodes - 1>::fill(ops);
+            pool_ops node_ops = { pool::allocate, pool::deallocate, pool::chunk_of,
+                                  pool::release_unused, pool::get_stats };
+            ops[nodes - 1] = node_ops;
+        }
+    };
+
+    template <int dummy>
+    struct ops_filler<0, dummy> {
+        static void fill(pool_ops *) { }
+    };
+
+    struct ops_table {
+        pool_ops ops[MaxNodes];
+        ops_table( ) { ops_filler<MaxNodes>::fill(ops); }
+    };
+
+    static const pool_ops &pool(int node)
+    {
+        static ops_table table;
+        return table.ops[node];
+    }
+
+private:
+    // the node of a thread is looked up again every NODE_REFRESH allocations
+    enum { NODE_REFRESH = 256 };
+
+    struct thread_state {
+        int bound_node;
+        int node;
+        unsigned calls;
+    };
+
+    static thread_state &local_state( )
+    {
+        static thread_local thread_state state = { -1, -1, 0 };
+        return state;
+    }
+
+    static std::atomic<int> simulated_nodes;
+
+#ifdef MINISTL_ALLOC_STATS
+    struct node_counters {
+        std::atomic<size_t> allocations;
+        std::atomic<size_t> deallocations;
+        std::atomic<size_t> remote_deallocations;
+    };
+    static node_counters counters[MaxNodes];
+#endif
+
+    static int detect_node( )
+    {
+        unsigned cpu = 0, node = 0;
+#ifdef __linux__
+        if (syscall(SYS_getcpu, &cpu, &node, (void *)0) != 0)
+            cpu = node = 0;
+#endif
+        int simulated = simulated_nodes.load(std::memory_order_relaxed);
+        if (simulated > 0)
+            return int(cpu % unsigned(simulated)) % MaxNodes;
+        return int(node % unsigned(MaxNodes));
+    }
+
+    static int current_node( )
+    {
+        thread_state &state = local_state( );
+        if (state.bound_node >= 0)
+            return state.bound_node;
+        if (state.node < 0 || (++state.calls & (NODE_REFRESH - 1)) == 0)
+            state.node = detect_node( );
+        return state.node;
+    }
+
+    static int owner_node(const void *p)
+    {
+        int owner = numa_region_map::get(p) - 1;
+        if (owner >= 0)
+            return owner;
+
+        // the region map does not reach p, ask the pools under their locks
+        int local = current_node( );
+        for (int i = 0; i < MaxNodes; ++i) {
+            int node = (local + i) % MaxNodes;
+            const char *base;
+            size_t size;
+            if (pool(node).chunk_of(p, base, size))
+                return node;
+        }
+        return local;
+    }
+
+    static void count(int node, bool allocation, bool remote)
+    {
+#ifdef MINISTL_ALLOC_STATS
+        if (allocation) {
+            counters[node].allocations.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            counters[node].deallocations.fetch_add(1, std::memory_order_relaxed);
+            if (remote)
+                counters[node].remote_deallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+#else
+        (void)node; (void)allocation; (void)remote;
+#endif
+    }
+
+    typedef malloc_alloc_template<0, ChunkSource> large_alloc;
+
+    static bool is_large(size_t n) { return n > (size_t)SizeClasses::max_bytes; }
+
+public:
+    static void *allocate(size_t n)
+    {
+        if (is_large(n))
+            return large_alloc::allocate(n);
+        int node = current_node( );
+        count(node, true, false);
+        return pool(node).allocate(n);
+    }
+
+    static void deallocate(void *p, size_t n)
+    {
+        if (is_large(n)) {
+            large_alloc::deallocate(p, n);
+            return;
+        }
+        int node = owner_node(p);
+        count(node, false, node != current_node( ));
+        pool(node).deallocate(p, n);
+    }
+
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz)
+    {
+        if (is_large(old_sz) && is_large(new_sz))
+            return large_alloc::reallocate(p, old_sz, new_sz);
+        if (!is_large(old_sz) && !is_large(new_sz) &&
+            SizeClasses::index(old_sz) == SizeClasses::index(new_sz))
+            return p;
+
+        void *result = allocate(new_sz);
+        memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+        deallocate(p, old_sz);
+        return result;
+    }
+
+    static size_t good_size(size_t n)
+    {
+        return is_large(n) ? large_alloc::good_size(n) : SizeClasses::class_size(SizeClasses::index(n));
+    }
+
+    // spread the cpus over n simulated nodes, 0 goes back to the real nodes
+    static void set_simulated_nodes(int n) { simulated_nodes.store(n); }
+
+    // pin the calling thread to node, -1 goes back to the node it runs on
+    static void bind_thread_to_node(int node)
+    {
+        local_state( ).bound_node = node < 0 ? -1 : node % MaxNodes;
+    }
+
+    static int node_of_current_thread( ) { return current_node( ); }
+
+    // number of nodes served: the simulated ones or the online ones
+    static int node_count( )
+    {
+        int simulated = simulated_nodes.load( );
+        if (simulated > 0)
+            return simulated < MaxNodes ? simulated : MaxNodes;
+
+        int nodes = 1;
+#ifdef __linux__
+        // the online nodes are listed as ranges, e.g. "0-1" or "0,2-3"
+        if (FILE *online = fopen("/sys/devices/system/node/online", "r")) {
+            int c, value = 0;
+            while ((c = fgetc(online)) != EOF) {
+                if (c >= '0' && c <= '9') {
+                    value = value * 10 + (c - '0');
+                } else {
+                    if (value + 1 > nodes)
+                        nodes = value + 1;
+                    value = 0;
+                }
+            }
+            if (value + 1 > nodes)
+                nodes = value + 1;
+            fclose(online);
+        }
+#endif
+        return nodes < MaxNodes ? nodes : MaxNodes;
+    }
+
+    static void get_node_stats(int node, numa_node_stats &stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+        pool(node).get_stats(stats.pool);
+#ifdef MINISTL_ALLOC_STATS
+        stats.allocations = counters[node].allocations.load(std::memory_order_relaxed);
+        stats.deallocations = counters[node].deallocations.load(std::memory_order_relaxed);
+        stats.remote_deallocations =
+            counters[node].remote_deallocations.load(std::memory_order_relaxed);
+#endif
+    }
+
+    static size_t release_unused( )
+    {
+        size_t released = 0;
+        for (int node = 0; node < MaxNodes; ++node)
+            released += pool(node).release_unused( );
+        return released;
+    }
+};
+
+template <int inst, int MaxNodes, typename SizeClasses, typename ChunkSource>
+std::atomic<int> numa_alloc_template<inst, MaxNodes, SizeClasses, ChunkSource>::simulated_nodes(0);
+
+#ifdef MINISTL_ALLOC_STATS
+template <int inst, int MaxNodes, typename SizeClasses, typename ChunkSource>
+typename numa_alloc_template<inst, MaxNodes, SizeClasses, ChunkSource>::node_counters
+    numa_alloc_template<inst, MaxNodes, SizeClasses, ChunkSource>::counters[MaxNodes];
+#endif
+
+typedef numa_alloc_template<0> numa_alloc;
+
+} // namespace ministl
+
+#endif // MINISTL_NUMA_ALLOC_H
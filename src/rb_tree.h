@@ -143,7 +143,7 @@ struct RbTreeIterator : public RbTreeIteratorBase {
 
 
 template <typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc = alloc>
-class rb_tree {
+class rb_tree : protected alloc_holder<Alloc> {
 protected:
   using void_pointer = void*;
   using base_ptr = RbTreeNodeBase*;
@@ -161,13 +161,14 @@ public:
   using link_type = rb_tree_node*;
   using size_type = size_t;
   using difference_type = ptrdiff_t;
+  using allocator_type = Alloc;
 
 public:
   using iterator = RbTreeIterator<value_type, reference, pointer>;
 
 public:
-  rb_tree(const Compare& comp = Compare( ))
-    : node_count(0), key_compare(comp)
+  rb_tree(const Compare& comp = Compare( ), const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a), node_count(0), key_compare(comp)
   {
     init( );
   }
@@ -178,6 +179,8 @@ public:
     put_node(header);
   }
 
+  allocator_type get_allocator( ) const { return this->allocator_ref( ); }
+
   iterator begin( ) { return leftmost( ); }
   iterator end( ) { return header( ); }
   bool empty( ) const { return node_count == 0; }
@@ -205,8 +208,8 @@ private:
   }
 
 protected:
-  link_type get_node( ) { return rb_tree_node_allocator::allocate( ); }
-  void put_node(link_type p) { rb_tree_node_allocator::deallocate(p); }
+  link_type get_node( ) { return rb_tree_node_allocator::allocate(this->allocator_ref( )); }
+  void put_node(link_type p) { rb_tree_node_allocator::deallocate(this->allocator_ref( ), p); }
 
   link_type create_node(const value_type& x)
   {
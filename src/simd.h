@@ -0,0 +1,489 @@
+#ifndef MINISTL_SIMD_H
+#define MINISTL_SIMD_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// The vectorized kernels of the algorithms. They are built for x86 with GCC,
+// Clang or MSVC and pick SSE2 or AVX2 at run time, other targets and builds
+// defining MINISTL_NO_SIMD use the scalar loops of the algorithms instead.
+#if !defined(MINISTL_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || \
+                                  defined(_M_X64) || defined(_M_IX86))
+#define MINISTL_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(MINISTL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MINISTL_TARGET_AVX2 __attribute__((target("avx2")))
+#define MINISTL_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define MINISTL_TARGET_AVX2
+#define MINISTL_TARGET_SSE2
+#endif
+
+namespace ministl {
+namespace simd {
+
+enum {
+    CPU_SSE2 = 1,
+    CPU_AVX2 = 2
+};
+
+inline int detect_cpu_features( )
+{
+    int features = 0;
+#if defined(MINISTL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init( );
+    if (__builtin_cpu_supports("sse2"))
+        features |= CPU_SSE2;
+    if (__builtin_cpu_supports("avx2"))
+        features |= CPU_AVX2;
+#elif defined(MINISTL_SIMD_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    if (info[3] & (1 << 26))
+        features |= CPU_SSE2;
+    // avx2 also needs the os to save the ymm registers
+    const bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                        (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    if (os_avx && (info[1] & (1 << 5)))
+        features |= CPU_AVX2;
+#endif
+    return features;
+}
+
+// the features of the cpu, detected once
+inline int cpu_features( )
+{
+    static const int features = detect_cpu_features( );
+    return features;
+}
+
+inline bool has_sse2( ) { return (cpu_features( ) & CPU_SSE2) != 0; }
+inline bool has_avx2( ) { return (cpu_features( ) & CPU_AVX2) != 0; }
+
+// ranges shorter than this many bytes are not worth a kernel
+enum { MIN_KERNEL_BYTES = 64 };
+
+// fill
+
+#ifdef MINISTL_SIMD_X86
+// the stores are aligned to 32 bytes, a store which splits a cache line
+// costs more than the unaligned ones which write the head and the tail.
+// twice holds the pattern two times, twice + k is the pattern as seen from
+// a byte k bytes after a multiple of 32.
+MINISTL_TARGET_AVX2
+inline void fill_pattern_avx2(char *dst, size_t bytes, const char *pattern)
+{
+    if (bytes < 32) {
+        memcpy(dst, pattern, bytes);
+        return;
+    }
+    const __m256i v0 = _mm256_loadu_si256((const __m256i *)pattern);
+    char twice[64];
+    _mm256_storeu_si256((__m256i *)twice, v0);
+    _mm256_storeu_si256((__m256i *)(twice + 32), v0);
+    _mm256_storeu_si256((__m256i *)dst, v0);
+
+    size_t i = (32 - ((size_t)dst & 31)) & 31;
+    const __m256i v = _mm256_loadu_si256((const __m256i *)(twice + i));
+    for (; i + 128 <= bytes; i += 128) {
+        _mm256_store_si256((__m256i *)(dst + i), v);
+        _mm256_store_si256((__m256i *)(dst + i + 32), v);
+        _mm256_store_si256((__m256i *)(dst + i + 64), v);
+        _mm256_store_si256((__m256i *)(dst + i + 96), v);
+    }
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_store_si256((__m256i *)(dst + i), v);
+    if (i != bytes)
+        _mm256_storeu_si256((__m256i *)(dst + bytes - 32),
+                            _mm256_loadu_si256((const __m256i *)(twice + (bytes & 31))));
+}
+
+MINISTL_TARGET_SSE2
+inline void fill_pattern_sse2(char *dst, size_t bytes, const char *pattern)
+{
+    const __m128i v = _mm_loadu_si128((const __m128i *)pattern);
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+        _mm_storeu_si128((__m128i *)(dst + i + 16), v);
+        _mm_storeu_si128((__m128i *)(dst + i + 32), v);
+        _mm_storeu_si128((__m128i *)(dst + i + 48), v);
+    }
+    for (; i + 16 <= bytes; i += 16)
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    memcpy(dst + i, pattern, bytes - i);
+}
+#endif
+
+inline void fill_pattern_scalar(char *dst, size_t bytes, const char *pattern)
+{
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32)
+        memcpy(dst + i, pattern, 32);
+    memcpy(dst + i, pattern, bytes - i);
+}
+
+// fill bytes bytes at dst with copies of the value_size bytes at value,
+// value_size must divide 32 and bytes must be a multiple of value_size
+inline void fill_pattern(void *dst, size_t bytes, const void *value, size_t value_size)
+{
+    char pattern[32];
+    for (size_t i = 0; i < sizeof(pattern); i += value_size)
+        memcpy(pattern + i, value, value_size);
+#ifdef MINISTL_SIMD_X86
+    if (has_avx2( )) {
+        fill_pattern_avx2((char *)dst, bytes, pattern);
+        return;
+    }
+    if (has_sse2( )) {
+        fill_pattern_sse2((char *)dst, bytes, pattern);
+        return;
+    }
+#endif
+    fill_pattern_scalar((char *)dst, bytes, pattern);
+}
+
+// find and count
+
+inline unsigned lowest_bit(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    unsigned n = 0;
+    for (; (mask & 1) == 0; mask >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline unsigned bit_count(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    mask = mask - ((mask >> 1) & 0x55555555u);
+    mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+    return (((mask + (mask >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#endif
+}
+
+// read a T from memory which may hold an object of another type
+template <typename T>
+inline T load(const void *p)
+{
+    T x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+#ifdef MINISTL_SIMD_X86
+// The comparisons of each element type. mask256 and mask128 compare a block
+// of 32 or 16 bytes to the splatted value and return a byte mask in which
+// each matching element sets sizeof(element) bits.
+struct eq_ops_i8 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v) { return _mm256_set1_epi8(*(const char *)v); }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), v));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v) { return _mm_set1_epi8(*(const char *)v); }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), v));
+    }
+};
+
+struct eq_ops_i16 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v) { return _mm256_set1_epi16(load<short>(v)); }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *)p), v));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v) { return _mm_set1_epi16(load<short>(v)); }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)p), v));
+    }
+};
+
+struct eq_ops_i32 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v) { return _mm256_set1_epi32(load<int>(v)); }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)p), v));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v) { return _mm_set1_epi32(load<int>(v)); }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)p), v));
+    }
+};
+
+struct eq_ops_i64 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v)
+    {
+        return _mm256_set1_epi64x(load<long long>(v));
+    }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        return _mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)p), v));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v)
+    {
+        return _mm_set1_epi64x(load<long long>(v));
+    }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        // sse2 has no 64 bit compare: both halves must be equal
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)p), v);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_movemask_epi8(eq);
+    }
+};
+
+struct eq_ops_f32 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v)
+    {
+        return _mm256_castps_si256(_mm256_set1_ps(*(const float *)v));
+    }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps((const float *)p), _mm256_castsi256_ps(v), _CMP_EQ_OQ);
+        return _mm256_movemask_epi8(_mm256_castps_si256(eq));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v)
+    {
+        return _mm_castps_si128(_mm_set1_ps(*(const float *)v));
+    }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        __m128 eq = _mm_cmpeq_ps(_mm_loadu_ps((const float *)p), _mm_castsi128_ps(v));
+        return _mm_movemask_epi8(_mm_castps_si128(eq));
+    }
+};
+
+struct eq_ops_f64 {
+    MINISTL_TARGET_AVX2 static __m256i splat256(const void *v)
+    {
+        return _mm256_castpd_si256(_mm256_set1_pd(*(const double *)v));
+    }
+    MINISTL_TARGET_AVX2 static unsigned mask256(const char *p, __m256i v)
+    {
+        __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd((const double *)p), _mm256_castsi256_pd(v), _CMP_EQ_OQ);
+        return _mm256_movemask_epi8(_mm256_castpd_si256(eq));
+    }
+    MINISTL_TARGET_SSE2 static __m128i splat128(const void *v)
+    {
+        return _mm_castpd_si128(_mm_set1_pd(*(const double *)v));
+    }
+    MINISTL_TARGET_SSE2 static unsigned mask128(const char *p, __m128i v)
+    {
+        __m128d eq = _mm_cmpeq_pd(_mm_loadu_pd((const double *)p), _mm_castsi128_pd(v));
+        return _mm_movemask_epi8(_mm_castpd_si128(eq));
+    }
+};
+
+template <typename T, size_t Size = sizeof(T), bool Float = std::is_floating_point<T>::value>
+struct eq_ops_of { };
+
+template <typename T> struct eq_ops_of<T, 1, false> { typedef eq_ops_i8 type; };
+template <typename T> struct eq_ops_of<T, 2, false> { typedef eq_ops_i16 type; };
+template <typename T> struct eq_ops_of<T, 4, false> { typedef eq_ops_i32 type; };
+template <typename T> struct eq_ops_of<T, 8, false> { typedef eq_ops_i64 type; };
+template <typename T> struct eq_ops_of<T, 4, true> { typedef eq_ops_f32 type; };
+template <typename T> struct eq_ops_of<T, 8, true> { typedef eq_ops_f64 type; };
+
+// the kernels scan the whole blocks of bytes bytes and leave the position
+// of the first match, or of the remaining tail, in pos
+template <typename Ops>
+MINISTL_TARGET_AVX2 inline bool find_equal_avx2(const char *p, size_t bytes, const void *value, size_t &pos)
+{
+    const __m256i v = Ops::splat256(value);
+    for (pos = 0; pos + 32 <= bytes; pos += 32) {
+        unsigned mask = Ops::mask256(p + pos, v);
+        if (mask != 0) {
+            pos += lowest_bit(mask);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Ops>
+MINISTL_TARGET_SSE2 inline bool find_equal_sse2(const char *p, size_t bytes, const void *value, size_t &pos)
+{
+    const __m128i v = Ops::splat128(value);
+    for (pos = 0; pos + 16 <= bytes; pos += 16) {
+        unsigned mask = Ops::mask128(p + pos, v);
+        if (mask != 0) {
+            pos += lowest_bit(mask);
+            return true;
+        }
+    }
+    return false;
+}
+
+// return the number of matching bytes
+template <typename Ops>
+MINISTL_TARGET_AVX2 inline size_t count_equal_avx2(const char *p, size_t bytes, const void *value, size_t &pos)
+{
+    const __m256i v = Ops::splat256(value);
+    size_t matches = 0;
+    for (pos = 0; pos + 32 <= bytes; pos += 32)
+        matches += bit_count(Ops::mask256(p + pos, v));
+    return matches;
+}
+
+template <typename Ops>
+MINISTL_TARGET_SSE2 inline size_t count_equal_sse2(const char *p, size_t bytes, const void *value, size_t &pos)
+{
+    const __m128i v = Ops::splat128(value);
+    size_t matches = 0;
+    for (pos = 0; pos + 16 <= bytes; pos += 16)
+        matches += bit_count(Ops::mask128(p + pos, v));
+    return matches;
+}
+#endif
+
+// value is true when find_equal and count_equal have a kernel for T
+template <typename T>
+struct has_equal_kernel {
+#ifdef MINISTL_SIMD_X86
+    enum {
+        value = std::is_arithmetic<T>::value && !std::is_same<T, long double>::value &&
+                (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+    };
+#else
+    enum { value = false };
+#endif
+};
+
+// index of the first of the n elements at first equal to value, n if none
+template <typename T>
+inline size_t find_equal(const T *first, size_t n, const T &value)
+{
+    size_t i = 0;
+#ifdef MINISTL_SIMD_X86
+    typedef typename eq_ops_of<T>::type ops;
+    size_t pos = 0;
+    bool found = false;
+    if (has_avx2( ))
+        found = find_equal_avx2<ops>((const char *)first, n * sizeof(T), &value, pos);
+    else if (has_sse2( ))
+        found = find_equal_sse2<ops>((const char *)first, n * sizeof(T), &value, pos);
+    i = pos / sizeof(T);
+    if (found)
+        return i;
+#endif
+    while (i != n && !(first[i] == value))
+        ++i;
+    return i;
+}
+
+// number of the n elements at first equal to value
+template <typename T>
+inline size_t count_equal(const T *first, size_t n, const T &value)
+{
+    size_t i = 0, result = 0;
+#ifdef MINISTL_SIMD_X86
+    typedef typename eq_ops_of<T>::type ops;
+    size_t pos = 0;
+    if (has_avx2( ))
+        result = count_equal_avx2<ops>((const char *)first, n * sizeof(T), &value, pos) / sizeof(T);
+    else if (has_sse2( ))
+        result = count_equal_sse2<ops>((const char *)first, n * sizeof(T), &value, pos) / sizeof(T);
+    i = pos / sizeof(T);
+#endif
+    for (; i != n; ++i) {
+        if (first[i] == value)
+            ++result;
+    }
+    return result;
+}
+
+// byte sets
+
+// A set of byte values, kept as a 256 bit map for the scalar lookups and as
+// two nibble tables for the shuffle kernel: bit h of rows_low[l] is set when
+// the byte h * 16 + l is a member, rows_high holds the members of 128 and up.
+struct byte_set {
+    unsigned long long bits[4];
+    unsigned char rows_low[16];
+    unsigned char rows_high[16];
+
+    byte_set( ) { memset(this, 0, sizeof(*this)); }
+
+    void insert(unsigned char c)
+    {
+        bits[c >> 6] |= 1ull << (c & 63);
+        if (c < 128)
+            rows_low[c & 15] |= (unsigned char)(1 << (c >> 4));
+        else
+            rows_high[c & 15] |= (unsigned char)(1 << ((c >> 4) - 8));
+    }
+
+    bool contains(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+};
+
+#ifdef MINISTL_SIMD_X86
+// the low nibble of each byte picks its row of the nibble tables, the high
+// nibble picks the bit of the row and, through its top bit, the table
+MINISTL_TARGET_AVX2
+inline bool find_byte_set_avx2(const unsigned char *p, size_t bytes, const byte_set &set, size_t &pos)
+{
+    const __m256i rows_low =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set.rows_low));
+    const __m256i rows_high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set.rows_high));
+    const __m256i bit_of = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    for (pos = 0; pos + 32 <= bytes; pos += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(p + pos));
+        const __m256i low = _mm256_and_si256(v, nibble);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows_low, low),
+                                               _mm256_shuffle_epi8(rows_high, low),
+                                               _mm256_slli_epi16(high, 4));
+        const __m256i bit = _mm256_shuffle_epi8(bit_of, high);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+        if (mask != 0) {
+            pos += lowest_bit(mask);
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// index of the first of the n bytes at first which is in set, n if none. The
+// shuffle kernel needs AVX2, other cpus look every byte up in the bit map.
+inline size_t find_byte_set(const unsigned char *first, size_t n, const byte_set &set)
+{
+    size_t i = 0;
+#ifdef MINISTL_SIMD_X86
+    if (has_avx2( )) {
+        size_t pos = 0;
+        if (find_byte_set_avx2(first, n, set, pos))
+            return pos;
+        i = pos;
+    }
+#endif
+    while (i != n && !set.contains(first[i]))
+        ++i;
+    return i;
+}
+
+} // namespace simd
+} // namespace ministl
+
+#endif // MINISTL_SIMD_H
@@ -0,0 +1,428 @@
+#ifndef MINISTL_SMALL_VECTOR_H
+#define MINISTL_SMALL_VECTOR_H
+
+#include <stddef.h>
+#include <utility>
+#include "alloc.h"
+#include "algorithm.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "uninitialized.h"
+
+namespace ministl {
+
+// A vector which keeps up to N elements in a buffer inside the object and
+// only allocates from Alloc when it grows past N elements. It has the
+// interface of vector, the iterators of an inline small_vector are
+// invalidated when it is moved or swapped.
+template <typename T, size_t N, class Alloc = alloc>
+class small_vector : protected alloc_holder<Alloc> {
+  static_assert(N > 0, "small_vector needs an inline capacity");
+
+public:
+  typedef T                 value_type;
+  typedef value_type*       iterator;
+  typedef const value_type* const_iterator;
+  typedef value_type*       pointer;
+  typedef const value_type* const_pointer;
+  typedef value_type&       reference;
+  typedef const value_type& const_reference;
+  typedef size_t            size_type;
+  typedef ptrdiff_t         difference_type;
+  typedef Alloc             allocator_type;
+
+public:
+  small_vector( ) { reset( ); }
+  explicit small_vector(const Alloc& a) : alloc_holder<Alloc>(a) { reset( ); }
+
+  small_vector(size_type n, const T& value, const Alloc& a = Alloc( )) : alloc_holder<Alloc>(a)
+  {
+    reset( );
+    insert(end( ), n, value);
+  }
+
+  explicit small_vector(size_type n, const Alloc& a = Alloc( )) : alloc_holder<Alloc>(a)
+  {
+    reset( );
+    insert(end( ), n, T( ));
+  }
+
+  template <typename InputIterator>
+  small_vector(InputIterator first, InputIterator last, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a)
+  {
+    reset( );
+    typedef typename is_integer<InputIterator>::integral integral;
+    insert_dispatch(end( ), first, last, integral( ));
+  }
+
+  small_vector(const small_vector& x) : alloc_holder<Alloc>(x.get_allocator( ))
+  {
+    reset( );
+    insert_dispatch(end( ), x.begin( ), x.end( ), false_type( ));
+  }
+
+  // the storage of a spilled x is taken over, inline elements are
+  // relocated. x is left empty.
+  small_vector(small_vector&& x) noexcept(std::is_nothrow_move_constructible<T>::value)
+    : alloc_holder<Alloc>(x.get_allocator( ))
+  {
+    reset( );
+    take(x);
+  }
+
+  ~small_vector( )
+  {
+    destory(start, finish);
+    deallocate( );
+  }
+
+  small_vector& operator=(const small_vector& x)
+  {
+    if (this != &x) {
+      clear( );
+      insert_dispatch(end( ), x.begin( ), x.end( ), false_type( ));
+    }
+    return *this;
+  }
+
+  // the allocator of x comes along with its storage
+  small_vector& operator=(small_vector&& x)
+    noexcept(std::is_nothrow_move_constructible<T>::value)
+  {
+    if (this != &x) {
+      clear( );
+      deallocate( );
+      reset( );
+      this->allocator_ref( ) = x.allocator_ref( );
+      take(x);
+    }
+    return *this;
+  }
+
+  // the allocators are swapped with the elements
+  void swap(small_vector& x)
+  {
+    if (this == &x)
+      return;
+    if (!is_inline( ) && !x.is_inline( )) {
+      ministl::swap(start, x.start);
+      ministl::swap(finish, x.finish);
+      ministl::swap(end_of_storage, x.end_of_storage);
+      ministl::swap(this->allocator_ref( ), x.allocator_ref( ));
+    } else {
+      small_vector tmp(std::move(x));
+      x = std::move(*this);
+      *this = std::move(tmp);
+    }
+  }
+
+  allocator_type get_allocator( ) const { return this->allocator_ref( ); }
+
+  iterator begin( ) { return start; }
+  const_iterator begin( ) const { return start; }
+  iterator end( ) { return finish; }
+  const_iterator end( ) const { return finish; }
+  reference front( ) { return *begin( ); }
+  const_reference front( ) const { return *begin( ); }
+  reference back( ) { return *(end( ) - 1); }
+  const_reference back( ) const { return *(end( ) - 1); }
+  size_type size( ) const { return size_type(finish - start); }
+  size_type capacity( ) const { return size_type(end_of_storage - start); }
+  bool empty( ) const { return begin( ) == end( ); }
+  reference operator[](size_type n) { return *(begin( ) + n); }
+  const_reference operator[](size_type n) const { return *(begin( ) + n); }
+
+  // true while the elements live in the inline buffer
+  bool is_inline( ) const { return start == inline_storage( ); }
+  static size_type inline_capacity( ) { return N; }
+
+  void push_back(const T& x) { emplace_back(x); }
+  void push_back(T&& x) { emplace_back(std::move(x)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args)
+  {
+    if (finish != end_of_storage) {
+      construct(finish, std::forward<Args>(args)...);
+      ++finish;
+    } else
+      emplace(end( ), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator emplace(iterator position, Args&&... args);
+
+  iterator insert(iterator position, const T& x) { return emplace(position, x); }
+  iterator insert(iterator position, T&& x) { return emplace(position, std::move(x)); }
+  void insert(iterator position, size_type n, const T& x);
+
+  template <typename InputIterator>
+  void insert(iterator position, InputIterator first, InputIterator last)
+  {
+    typedef typename is_integer<InputIterator>::integral integral;
+    insert_dispatch(position, first, last, integral( ));
+  }
+
+  void pop_back( )
+  {
+    --finish;
+    destory(finish);
+  }
+
+  iterator erase(iterator position) { return erase(position, position + 1); }
+
+  iterator erase(iterator first, iterator last)
+  {
+    iterator i = ministl::move(last, finish, first);
+    destory(i, finish);
+    finish = i;
+    return first;
+  }
+
+  void clear( ) { erase(begin( ), end( )); }
+
+  // replace the elements with n copies of x or with the range [first, last)
+  void assign(size_type n, const T& x)
+  {
+    T x_copy = x;
+    clear( );
+    insert(end( ), n, x_copy);
+  }
+
+  template <typename InputIterator>
+  void assign(InputIterator first, InputIterator last)
+  {
+    clear( );
+    insert(end( ), first, last);
+  }
+
+  void resize(size_type new_size, const T& x)
+  {
+    if (new_size < size( ))
+      erase(begin( ) + new_size, end( ));
+    else
+      insert(end( ), new_size - size( ), x);
+  }
+  void resize(size_type new_size) { resize(new_size, T( )); }
+
+  void reserve(size_type n)
+  {
+    if (n > capacity( ))
+      relocate_storage(n, relocatable( ));
+  }
+
+  // give the unused capacity back to the allocator, elements which fit
+  // move back into the inline buffer
+  void shrink_to_fit( )
+  {
+    if (is_inline( ) || finish == end_of_storage)
+      return;
+    if (size( ) > N) {
+      relocate_storage(size( ), relocatable( ));
+      return;
+    }
+    iterator old_start = start, old_finish = finish, old_end = end_of_storage;
+    reset( );
+    try {
+      finish = ministl::uninitialized_relocate(old_start, old_finish, start);
+    } catch (...) {
+      start = old_start;
+      finish = old_finish;
+      end_of_storage = old_end;
+      throw;
+    }
+    data_allocator::deallocate(this->allocator_ref( ), old_start, old_end - old_start);
+  }
+
+private:
+  typedef simple_alloc<value_type, Alloc> data_allocator;
+  typedef typename is_trivially_relocatable<T>::type relocatable;
+
+  T* inline_storage( ) { return reinterpret_cast<T*>(buffer); }
+  const T* inline_storage( ) const { return reinterpret_cast<const T*>(buffer); }
+
+  void reset( )
+  {
+    start = finish = inline_storage( );
+    end_of_storage = start + N;
+  }
+
+  void deallocate( )
+  {
+    if (!is_inline( ))
+      data_allocator::deallocate(this->allocator_ref( ), start, capacity( ));
+  }
+
+  // move the elements of x into the empty inline storage of *this
+  void take(small_vector& x)
+  {
+    if (x.is_inline( )) {
+      finish = ministl::uninitialized_relocate(x.start, x.finish, start);
+      x.finish = x.start;
+    } else {
+      start = x.start;
+      finish = x.finish;
+      end_of_storage = x.end_of_storage;
+      x.reset( );
+    }
+  }
+
+  size_type grow_capacity(size_type required) const
+  {
+    const size_type len = 2 * capacity( );
+    return len < required ? required : len;
+  }
+
+  // a spilled trivially relocatable storage grows through reallocate, in
+  // place when it can
+  void relocate_storage(size_type len, true_type)
+  {
+    if (is_inline( )) {
+      relocate_storage(len, false_type( ));
+    } else {
+      const size_type old_size = size( );
+      start = data_allocator::reallocate(this->allocator_ref( ), start, capacity( ), len);
+      finish = start + old_size;
+      end_of_storage = start + len;
+    }
+  }
+
+  void relocate_storage(size_type len, false_type)
+  {
+    iterator new_start = data_allocator::allocate(this->allocator_ref( ), len);
+    iterator new_finish;
+    try {
+      new_finish = ministl::uninitialized_relocate(start, finish, new_start);
+    } catch (...) {
+      data_allocator::deallocate(this->allocator_ref( ), new_start, len);
+      throw;
+    }
+    deallocate( );
+    start = new_start;
+    finish = new_finish;
+    end_of_storage = start + len;
+  }
+
+  template <typename Integer>
+  void insert_dispatch(iterator position, Integer n, Integer x, true_type)
+  {
+    insert(position, size_type(n), T(x));
+  }
+
+  template <typename InputIterator>
+  void insert_dispatch(iterator position, InputIterator first, InputIterator last, false_type)
+  {
+    typedef typename iterator_traits<InputIterator>::iterator_category category;
+    range_insert(position, first, last, category( ));
+  }
+
+  template <typename InputIterator>
+  void range_insert(iterator position, InputIterator first, InputIterator last,
+                    input_iterator_tag)
+  {
+    for (; first != last; ++first, ++position)
+      position = insert(position, *first);
+  }
+
+  template <typename ForwardIterator>
+  void range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                    forward_iterator_tag);
+
+private:
+  iterator start;
+  iterator finish;
+  iterator end_of_storage;
+  alignas(T) unsigned char buffer[N * sizeof(T)];
+};
+
+template <typename T, size_t N, class Alloc>
+template <typename... Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(iterator position, Args&&... args)
+{
+  const size_type n = position - start;
+  if (position == finish && finish != end_of_storage) {
+    construct(finish, std::forward<Args>(args)...);
+    ++finish;
+    return position;
+  }
+
+  // args may refer to an element about to move
+  T x_copy(std::forward<Args>(args)...);
+  if (finish == end_of_storage)
+    relocate_storage(grow_capacity(size( ) + 1), relocatable( ));
+  position = start + n;
+  if (position == finish) {
+    construct(finish, std::move(x_copy));
+    ++finish;
+  } else {
+    construct(finish, std::move(*(finish - 1)));
+    ++finish;
+    ministl::move_backward(position, finish - 2, finish - 1);
+    *position = std::move(x_copy);
+  }
+  return position;
+}
+
+template <typename T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::insert(iterator position, size_type n, const T& x)
+{
+  if (n == 0)
+    return;
+  const size_type offset = position - start;
+  T x_copy = x;
+  if (size_type(end_of_storage - finish) < n)
+    relocate_storage(grow_capacity(size( ) + n), relocatable( ));
+  position = start + offset;
+
+  const size_type elems_after = finish - position;
+  iterator old_finish = finish;
+  if (elems_after > n) {
+    ministl::uninitialized_move(finish - n, finish, finish);
+    finish += n;
+    ministl::move_backward(position, old_finish - n, old_finish);
+    ministl::fill(position, position + n, x_copy);
+  } else {
+    ministl::uninitialized_fill_n(finish, n - elems_after, x_copy);
+    finish += n - elems_after;
+    ministl::uninitialized_move(position, old_finish, finish);
+    finish += elems_after;
+    ministl::fill(position, old_finish, x_copy);
+  }
+}
+
+template <typename T, size_t N, class Alloc>
+template <typename ForwardIterator>
+void small_vector<T, N, Alloc>::range_insert(iterator position, ForwardIterator first,
+                                             ForwardIterator last, forward_iterator_tag)
+{
+  if (first == last)
+    return;
+  const size_type n = ministl::distance(first, last);
+  const size_type offset = position - start;
+  if (size_type(end_of_storage - finish) < n)
+    relocate_storage(grow_capacity(size( ) + n), relocatable( ));
+  position = start + offset;
+
+  const size_type elems_after = finish - position;
+  iterator old_finish = finish;
+  if (elems_after > n) {
+    ministl::uninitialized_move(finish - n, finish, finish);
+    finish += n;
+    ministl::move_backward(position, old_finish - n, old_finish);
+    ministl::copy(first, last, position);
+  } else {
+    ForwardIterator mid = first;
+    ministl::advance(mid, elems_after);
+    ministl::uninitialized_copy(mid, last, finish);
+    finish += n - elems_after;
+    ministl::uninitialized_move(position, old_finish, finish);
+    finish += elems_after;
+    ministl::copy(first, mid, position);
+  }
+}
+
+} // namespace ministl
+
+#endif // MINISTL_SMALL_VECTOR_H
@@ -0,0 +1,449 @@
+#ifndef MINISTL_SORT_H
+#define MINISTL_SORT_H
+
+#include <stddef.h>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "alloc.h"
+#include "algorithm.h"
+#include "construct.h"
+#include "heap.h"
+#include "uninitialized.h"
+
+namespace ministl {
+
+//------------------------------------------------------------------------------
+// algorithms for sorting
+//------------------------------------------------------------------------------
+// names of algorithms: sort, stable_sort, partial_sort, nth_element,
+//                      radix_sort
+//------------------------------------------------------------------------------
+
+// ranges of this many elements or fewer are left to insertion sort
+enum { SORT_THRESHOLD = 16 };
+
+// the comparison of the overloads without a Compare argument
+struct __sort_less {
+  template <typename T1, typename T2>
+  bool operator()(const T1& a, const T2& b) const { return a < b; }
+};
+
+// floor(log2(n)) for n > 0
+template <typename Size>
+inline Size __lg(Size n)
+{
+  Size k = 0;
+  for (; n > 1; n >>= 1)
+    ++k;
+  return k;
+}
+
+// *next is the sentinel which stops the scan, so no bound is checked
+template <typename RandomAccessIterator, typename Compare>
+void __unguarded_linear_insert(RandomAccessIterator last, Compare comp)
+{
+  typename iterator_traits<RandomAccessIterator>::value_type value = std::move(*last);
+  RandomAccessIterator next = last;
+  --next;
+  while (comp(value, *next)) {
+    *last = std::move(*next);
+    last = next;
+    --next;
+  }
+  *last = std::move(value);
+}
+
+template <typename RandomAccessIterator, typename Compare>
+void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  if (first == last)
+    return;
+  for (RandomAccessIterator i = first + 1; i != last; ++i) {
+    if (comp(*i, *first)) {
+      typename iterator_traits<RandomAccessIterator>::value_type value = std::move(*i);
+      ministl::move_backward(first, i, i + 1);
+      *first = std::move(value);
+    } else {
+      ministl::__unguarded_linear_insert(i, comp);
+    }
+  }
+}
+
+// after the introsort loop every element is less than SORT_THRESHOLD places
+// away from its slot, and the first block holds the minimum
+template <typename RandomAccessIterator, typename Compare>
+void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  if (last - first > SORT_THRESHOLD) {
+    ministl::__insertion_sort(first, first + SORT_THRESHOLD, comp);
+    for (RandomAccessIterator i = first + SORT_THRESHOLD; i != last; ++i)
+      ministl::__unguarded_linear_insert(i, comp);
+  } else {
+    ministl::__insertion_sort(first, last, comp);
+  }
+}
+
+template <typename RandomAccessIterator, typename Compare>
+void __move_median_to_first(RandomAccessIterator result, RandomAccessIterator a,
+                            RandomAccessIterator b, RandomAccessIterator c, Compare comp)
+{
+  if (comp(*a, *b)) {
+    if (comp(*b, *c))
+      ministl::iter_swap(result, b);
+    else if (comp(*a, *c))
+      ministl::iter_swap(result, c);
+    else
+      ministl::iter_swap(result, a);
+  } else if (comp(*a, *c)) {
+    ministl::iter_swap(result, a);
+  } else if (comp(*b, *c)) {
+    ministl::iter_swap(result, c);
+  } else {
+    ministl::iter_swap(result, b);
+  }
+}
+
+// Hoare partition around *pivot, which lies outside [first, last). The median
+// of three guarantees an element on each side which stops the scans.
+template <typename RandomAccessIterator, typename Compare>
+RandomAccessIterator __unguarded_partition(RandomAccessIterator first, RandomAccessIterator last,
+                                           RandomAccessIterator pivot, Compare comp)
+{
+  while (true) {
+    while (comp(*first, *pivot))
+      ++first;
+    --last;
+    while (comp(*pivot, *last))
+      --last;
+    if (!(first < last))
+      return first;
+    ministl::iter_swap(first, last);
+    ++first;
+  }
+}
+
+// return cut such that no element of [first, cut) is greater than an element
+// of [cut, last)
+template <typename RandomAccessIterator, typename Compare>
+inline RandomAccessIterator __partition_pivot(RandomAccessIterator first, RandomAccessIterator last,
+                                              Compare comp)
+{
+  RandomAccessIterator mid = first + (last - first) / 2;
+  ministl::__move_median_to_first(first, first + 1, mid, last - 1, comp);
+  return ministl::__unguarded_partition(first + 1, last, first, comp);
+}
+
+// the heap of [first, middle) keeps the smallest elements seen so far, its
+// top is replaced by each smaller element of [middle, last)
+template <typename RandomAccessIterator, typename Compare>
+void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
+                  RandomAccessIterator last, Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+
+  ministl::make_heap(first, middle, comp);
+  for (RandomAccessIterator i = middle; i < last; ++i) {
+    if (comp(*i, *first)) {
+      value_type value = std::move(*i);
+      *i = std::move(*first);
+      ministl::adjust_heap(first, difference_type(0), difference_type(middle - first),
+                           std::move(value), comp);
+    }
+  }
+  ministl::sort_heap(first, middle, comp);
+}
+
+template <typename RandomAccessIterator>
+inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
+                         RandomAccessIterator last)
+{
+  ministl::partial_sort(first, middle, last, __sort_less( ));
+}
+
+// quicksort until the recursion is deeper than depth_limit, which is left to
+// heap sort, and blocks of SORT_THRESHOLD elements are left unsorted
+template <typename RandomAccessIterator, typename Size, typename Compare>
+void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last,
+                      Size depth_limit, Compare comp)
+{
+  while (last - first > SORT_THRESHOLD) {
+    if (depth_limit == 0) {
+      ministl::partial_sort(first, last, last, comp);
+      return;
+    }
+    --depth_limit;
+    RandomAccessIterator cut = ministl::__partition_pivot(first, last, comp);
+    ministl::__introsort_loop(cut, last, depth_limit, comp);
+    last = cut;
+  }
+}
+
+// introsort: median of three quicksort, heap sort past 2 * log2(n) levels and
+// a final insertion sort
+template <typename RandomAccessIterator, typename Compare>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  if (last - first < 2)
+    return;
+  ministl::__introsort_loop(first, last, ministl::__lg(last - first) * 2, comp);
+  ministl::__final_insertion_sort(first, last, comp);
+}
+
+template <typename RandomAccessIterator>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+  ministl::sort(first, last, __sort_less( ));
+}
+
+// the left run is moved to buffer, then both runs are merged back into
+// [first, last), the left one winning ties
+template <typename RandomAccessIterator, typename Pointer, typename Compare>
+void __merge_with_buffer(RandomAccessIterator first, RandomAccessIterator middle,
+                         RandomAccessIterator last, Pointer buffer, Compare comp)
+{
+  Pointer buffer_end = ministl::uninitialized_move(first, middle, buffer);
+  Pointer left = buffer;
+  while (left != buffer_end && middle != last) {
+    if (comp(*middle, *left)) {
+      *first = std::move(*middle);
+      ++middle;
+    } else {
+      *first = std::move(*left);
+      ++left;
+    }
+    ++first;
+  }
+  ministl::move(left, buffer_end, first);
+  destory(buffer, buffer_end);
+}
+
+template <typename RandomAccessIterator, typename Pointer, typename Compare>
+void __merge_sort_with_buffer(RandomAccessIterator first, RandomAccessIterator last,
+                              Pointer buffer, Compare comp)
+{
+  if (last - first <= SORT_THRESHOLD) {
+    ministl::__insertion_sort(first, last, comp);
+    return;
+  }
+  RandomAccessIterator middle = first + (last - first) / 2;
+  ministl::__merge_sort_with_buffer(first, middle, buffer, comp);
+  ministl::__merge_sort_with_buffer(middle, last, buffer, comp);
+  // runs already in order need no merge
+  if (comp(*middle, *(middle - 1)))
+    ministl::__merge_with_buffer(first, middle, last, buffer, comp);
+}
+
+// merge sort keeping the order of equivalent elements. The buffer holds the
+// left half of a merge, n / 2 elements allocated from alloc.
+template <typename RandomAccessIterator, typename Compare>
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+  typedef simple_alloc<value_type, alloc> buffer_allocator;
+
+  const size_t len = last - first;
+  if (len <= SORT_THRESHOLD) {
+    ministl::__insertion_sort(first, last, comp);
+    return;
+  }
+  const size_t buffer_size = len / 2;
+  value_type* buffer = buffer_allocator::allocate(buffer_size);
+  try {
+    ministl::__merge_sort_with_buffer(first, last, buffer, comp);
+  } catch (...) {
+    buffer_allocator::deallocate(buffer, buffer_size);
+    throw;
+  }
+  buffer_allocator::deallocate(buffer, buffer_size);
+}
+
+template <typename RandomAccessIterator>
+inline void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+  ministl::stable_sort(first, last, __sort_less( ));
+}
+
+// introselect: only the side of each partition holding nth is partitioned
+// again, past 2 * log2(n) levels the rest is left to partial_sort
+template <typename RandomAccessIterator, typename Compare>
+void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                 RandomAccessIterator last, Compare comp)
+{
+  if (first == last || nth == last)
+    return;
+  typename iterator_traits<RandomAccessIterator>::difference_type depth_limit =
+    ministl::__lg(last - first) * 2;
+  while (last - first > 3) {
+    if (depth_limit == 0) {
+      ministl::partial_sort(first, nth + 1, last, comp);
+      return;
+    }
+    --depth_limit;
+    RandomAccessIterator cut = ministl::__partition_pivot(first, last, comp);
+    if (cut <= nth)
+      first = cut;
+    else
+      last = cut;
+  }
+  ministl::__insertion_sort(first, last, comp);
+}
+
+template <typename RandomAccessIterator>
+inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                        RandomAccessIterator last)
+{
+  ministl::nth_element(first, nth, last, __sort_less( ));
+}
+
+// ranges shorter than this are left to insertion sort
+enum { RADIX_SORT_THRESHOLD = 64 };
+
+// __radix_key<K>::encode maps a key to an unsigned integer of the same size
+// which orders like the key: signed integers get their sign bit flipped
+template <typename K, bool Float = std::is_floating_point<K>::value>
+struct __radix_key {
+  static_assert(std::is_integral<K>::value && !std::is_same<K, bool>::value,
+                "radix_sort needs integer or floating point keys");
+  typedef typename std::make_unsigned<K>::type type;
+
+  static type encode(K key)
+  {
+    const type sign = std::is_signed<K>::value ? type(type(1) << (sizeof(K) * 8 - 1)) : type(0);
+    return type(type(key) ^ sign);
+  }
+};
+
+// negative floating point keys get all their bits flipped and the others
+// their sign bit, which orders them -nan < -inf < -0.0 < 0.0 < inf < nan
+template <typename K>
+struct __radix_key<K, true> {
+  static_assert(sizeof(K) == 4 || sizeof(K) == 8, "radix_sort needs float or double keys");
+  typedef typename std::conditional<sizeof(K) == 4, unsigned int, unsigned long long>::type type;
+
+  static type encode(K key)
+  {
+    type bits;
+    memcpy(&bits, &key, sizeof(bits));
+    const type sign = type(1) << (sizeof(type) * 8 - 1);
+    return (bits & sign) ? type(~bits) : type(bits | sign);
+  }
+};
+
+struct __radix_identity {
+  template <typename T>
+  const T& operator()(const T& x) const { return x; }
+};
+
+template <typename KeyExtractor, typename Traits>
+struct __radix_compare {
+  explicit __radix_compare(KeyExtractor key) : key(key) { }
+
+  template <typename T>
+  bool operator()(const T& a, const T& b) const
+  {
+    return Traits::encode(key(a)) < Traits::encode(key(b));
+  }
+
+  KeyExtractor key;
+};
+
+// LSD radix sort on the bytes of the keys, stable. One pass over the range
+// counts the digits of every byte, the passes whose digit is the same for all
+// the keys are skipped, the others scatter the elements between the range and
+// a buffer of n elements allocated from Alloc, which is only allocated when a
+// pass runs.
+template <class Alloc = alloc, typename T, typename KeyExtractor>
+void radix_sort(T* first, T* last, KeyExtractor key)
+{
+  typedef typename std::decay<decltype(key(*first))>::type key_type;
+  typedef __radix_key<key_type> traits;
+  typedef typename traits::type unsigned_key;
+  typedef simple_alloc<T, Alloc> buffer_allocator;
+  enum { PASSES = sizeof(unsigned_key) };
+
+  const size_t n = last - first;
+  if (n < RADIX_SORT_THRESHOLD) {
+    ministl::__insertion_sort(first, last, __radix_compare<KeyExtractor, traits>(key));
+    return;
+  }
+
+  size_t counts[PASSES][256];
+  memset(counts, 0, sizeof(counts));
+  for (T* p = first; p != last; ++p) {
+    const unsigned_key k = traits::encode(key(*p));
+    for (int pass = 0; pass < PASSES; ++pass)
+      ++counts[pass][(k >> (8 * pass)) & 0xff];
+  }
+
+  // the first pass which runs scatters the range into the raw buffer,
+  // constructing the elements there, the next ones move them back and forth
+  // by assignment. Only an odd number of passes leaves them in the buffer.
+  T* buffer = 0;
+  size_t begin[256], offset[256];
+  bool building = false, built = false;
+  try {
+    T* from = first;
+    T* to = first;
+    for (int pass = 0; pass < PASSES; ++pass) {
+      const size_t* count = counts[pass];
+      const int shift = 8 * pass;
+      if (count[(traits::encode(key(*from)) >> shift) & 0xff] == n)
+        continue;
+
+      size_t sum = 0;
+      for (int digit = 0; digit < 256; ++digit) {
+        begin[digit] = offset[digit] = sum;
+        sum += count[digit];
+      }
+      if (!buffer) {
+        buffer = buffer_allocator::allocate(n);
+        to = buffer;
+      }
+      if (!built) {
+        building = true;
+        for (T* p = from; p != from + n; ++p) {
+          size_t& slot = offset[(traits::encode(key(*p)) >> shift) & 0xff];
+          construct(to + slot, std::move(*p));
+          ++slot;
+        }
+        built = true;
+      } else {
+        for (T* p = from; p != from + n; ++p)
+          to[offset[(traits::encode(key(*p)) >> shift) & 0xff]++] = std::move(*p);
+      }
+      T* tmp = from;
+      from = to;
+      to = tmp;
+    }
+    if (from != first)
+      ministl::move(from, from + n, first);
+  } catch (...) {
+    if (built) {
+      destory(buffer, buffer + n);
+    } else if (building) {
+      // the elements built so far fill the start of every digit's bucket
+      for (int digit = 0; digit < 256; ++digit)
+        destory(buffer + begin[digit], buffer + offset[digit]);
+    }
+    if (buffer)
+      buffer_allocator::deallocate(buffer, n);
+    throw;
+  }
+  if (buffer) {
+    destory(buffer, buffer + n);
+    buffer_allocator::deallocate(buffer, n);
+  }
+}
+
+// sort integers, float or double values
+template <class Alloc = alloc, typename T>
+inline void radix_sort(T* first, T* last)
+{
+  ministl::radix_sort<Alloc>(first, last, __radix_identity( ));
+}
+
+} // namespace ministl
+
+#endif // MINISTL_SORT_H
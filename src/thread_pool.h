@@ -0,0 +1,482 @@
+#ifndef MINISTL_THREAD_POOL_H
+#define MINISTL_THREAD_POOL_H
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "alloc.h"
+#include "construct.h"
+#include "deque.h"
+
+namespace ministl {
+
+// The deque of Chase and Lev ("Dynamic Circular Work-Stealing Deque", with
+// the memory orders of Le et al.): the owner thread pushes and pops at the
+// bottom without locking, any other thread steals from the top. T must be
+// trivially copyable, the pool stores task pointers. A full ring is copied
+// into one twice as large; the old rings may still be read by thieves, so
+// they are only freed with the deque.
+template <typename T, class Alloc = multithread_alloc>
+class work_stealing_deque {
+private:
+    struct ring {
+        ptrdiff_t capacity;
+        std::atomic<T> *slots;
+        ring *retired;
+
+        T get(ptrdiff_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(ptrdiff_t i, T x) { slots[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+    };
+
+    typedef simple_alloc<ring, Alloc> ring_allocator;
+    typedef simple_alloc<std::atomic<T>, Alloc> slot_allocator;
+
+public:
+    // capacity is rounded up to a power of two so that indices can be masked
+    explicit work_stealing_deque(ptrdiff_t capacity = 64) : top(0), bottom(0)
+    {
+        ptrdiff_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        array.store(make_ring(size, 0), std::memory_order_relaxed);
+    }
+
+    ~work_stealing_deque( )
+    {
+        ring *r = array.load(std::memory_order_relaxed);
+        while (r) {
+            ring *next = r->retired;
+            slot_allocator::deallocate(r->slots, r->capacity);
+            ring_allocator::deallocate(r);
+            r = next;
+        }
+    }
+
+    // owner only
+    void push(T x)
+    {
+        ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+        ptrdiff_t t = top.load(std::memory_order_acquire);
+        ring *r = array.load(std::memory_order_relaxed);
+        if (b - t > r->capacity - 1)
+            r = grow(r, t, b);
+        r->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only, the last pushed element first
+    bool pop(T &x)
+    {
+        ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring *r = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        x = r->get(b);
+        if (t == b) {
+            // the last element, a thief may be taking it too
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // any thread, the oldest element first. Fails when the deque is empty
+    // or another thread took the element first.
+    bool steal(T &x)
+    {
+        ptrdiff_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        ring *r = array.load(std::memory_order_acquire);
+        x = r->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed);
+    }
+
+    bool empty( ) const
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    work_stealing_deque(const work_stealing_deque &);
+    work_stealing_deque &operator=(const work_stealing_deque &);
+
+    static ring *make_ring(ptrdiff_t capacity, ring *retired)
+    {
+        ring *r = ring_allocator::allocate( );
+        r->capacity = capacity;
+        r->retired = retired;
+        r->slots = slot_allocator::allocate(capacity);
+        for (ptrdiff_t i = 0; i < capacity; ++i)
+            construct(r->slots + i, T( ));
+        return r;
+    }
+
+    ring *grow(ring *r, ptrdiff_t t, ptrdiff_t b)
+    {
+        ring *bigger = make_ring(r->capacity * 2, r);
+        for (ptrdiff_t i = t; i < b; ++i)
+            bigger->put(i, r->get(i));
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+private:
+    std::atomic<ptrdiff_t> top;
+    std::atomic<ptrdiff_t> bottom;
+    std::atomic<ring *> array;
+};
+
+// a forked task, run once by any thread of the pool
+struct __pool_task {
+    void (*run)(__pool_task *task);
+    std::atomic<bool> done;
+    std::exception_ptr error;
+};
+
+template <typename F>
+struct __pool_task_of : __pool_task {
+    F body;
+
+    template <typename G>
+    explicit __pool_task_of(G &&g) : body(std::forward<G>(g))
+    {
+        run = &invoke;
+        done.store(false, std::memory_order_relaxed);
+    }
+
+    static void invoke(__pool_task *task) { static_cast<__pool_task_of *>(task)->body( ); }
+};
+
+template <typename F>
+class task_handle;
+
+// A pool of worker threads running forked tasks. Each worker owns a
+// work_stealing_deque: it pops its own tasks from the bottom and, when it has
+// none left, steals from the top of the deques of the others. Tasks forked
+// from outside the pool go to a shared queue. A thread joining a task runs
+// other tasks until it is done, so tasks forking and joining tasks do not
+// deadlock. The tasks, the deques and the queue use multithread_alloc.
+class thread_pool {
+private:
+    struct worker {
+        std::thread thread;
+        work_stealing_deque<__pool_task *> tasks;
+    };
+
+    typedef simple_alloc<worker, multithread_alloc> worker_allocator;
+
+    // the worker of the calling thread in the pool it works for
+    struct thread_state {
+        thread_pool *pool;
+        size_t index;
+    };
+
+    static thread_state &local_state( )
+    {
+        static thread_local thread_state state = { 0, 0 };
+        return state;
+    }
+
+public:
+    // threads workers, hardware_concurrency( ) - 1 when 0 is given
+    explicit thread_pool(unsigned threads = 0)
+        : stopping(false), queued(0), sleepers(0), injected_count(0)
+    {
+        if (threads == 0) {
+            unsigned hardware = std::thread::hardware_concurrency( );
+            threads = hardware > 1 ? hardware - 1 : 0;
+        }
+        worker_count = threads;
+        workers = worker_allocator::allocate(worker_count);
+        for (size_t i = 0; i < worker_count; ++i)
+            construct(workers + i);
+        for (size_t i = 0; i < worker_count; ++i)
+            workers[i].thread = std::thread(&thread_pool::work, this, i);
+    }
+
+    ~thread_pool( )
+    {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            stopping = true;
+        }
+        wake_up.notify_all( );
+        for (size_t i = 0; i < worker_count; ++i)
+            workers[i].thread.join( );
+        for (size_t i = 0; i < worker_count; ++i)
+            destory(workers + i);
+        worker_allocator::deallocate(workers, worker_count);
+    }
+
+    // the number of threads running tasks: the workers and the caller
+    size_t concurrency( ) const { return worker_count + 1; }
+
+    // start f( ) on the pool. The returned handle must be joined, its
+    // destructor waits for the task otherwise.
+    template <typename F>
+    task_handle<typename std::decay<F>::type> fork(F &&f);
+
+    // run body(begin, end) on subranges of [first, last) of at most grain
+    // elements, split in halves which are forked and joined. A grain of 0
+    // makes about 8 subranges per thread. The first exception thrown by body
+    // is rethrown here.
+    template <typename RandomAccessIterator, typename Body>
+    void parallel_for(RandomAccessIterator first, RandomAccessIterator last, const Body &body,
+                      size_t grain = 0)
+    {
+        const size_t n = last - first;
+        if (n == 0)
+            return;
+        if (grain == 0)
+            grain = n / (concurrency( ) * 8);
+        split(first, last, body, grain > 0 ? grain : 1);
+    }
+
+    // run body(i) for every i in [0, chunks) and return when all are done
+    template <typename Body>
+    void parallel_chunks(size_t chunks, const Body &body)
+    {
+        parallel_for(size_t(0), chunks, [&body](size_t begin, size_t end) {
+            for (; begin != end; ++begin)
+                body(begin);
+        }, 1);
+    }
+
+    // the pool the parallel algorithms run on
+    static thread_pool &default_pool( )
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+private:
+    template <typename F>
+    friend class task_handle;
+
+    thread_pool(const thread_pool &);
+    thread_pool &operator=(const thread_pool &);
+
+    template <typename RandomAccessIterator, typename Body>
+    void split(RandomAccessIterator first, RandomAccessIterator last, const Body &body, size_t grain)
+    {
+        if (size_t(last - first) <= grain) {
+            body(first, last);
+            return;
+        }
+        RandomAccessIterator middle = first + (last - first) / 2;
+        auto right = fork([this, middle, last, &body, grain]( ) { split(middle, last, body, grain); });
+        split(first, middle, body, grain);
+        right.join( );
+    }
+
+    worker *own_worker( )
+    {
+        thread_state &state = local_state( );
+        return state.pool == this ? workers + state.index : 0;
+    }
+
+    void submit(__pool_task *task)
+    {
+        // counted first, a worker seeing no task yet looks again
+        queued.fetch_add(1);
+        if (worker *w = own_worker( )) {
+            w->tasks.push(task);
+        } else {
+            std::lock_guard<std::mutex> guard(inject_lock);
+            injected.push_back(task);
+            injected_count.fetch_add(1);
+        }
+        if (sleepers.load( ) != 0) {
+            {
+                std::lock_guard<std::mutex> guard(sleep_lock);
+            }
+            wake_up.notify_one( );
+        }
+    }
+
+    static void execute(__pool_task *task)
+    {
+        try {
+            task->run(task);
+        } catch (...) {
+            task->error = std::current_exception( );
+        }
+        task->done.store(true, std::memory_order_release);
+    }
+
+    // the bottom of our own deque first, then the shared queue, then the tops
+    // of the deques of the others
+    bool find_task(__pool_task *&task)
+    {
+        thread_state &state = local_state( );
+        const bool inside = state.pool == this;
+        if (inside && workers[state.index].tasks.pop(task))
+            return taken( );
+        if (injected_count.load( ) != 0) {
+            std::lock_guard<std::mutex> guard(inject_lock);
+            if (!injected.empty( )) {
+                task = injected.front( );
+                injected.pop_front( );
+                injected_count.fetch_sub(1);
+                return taken( );
+            }
+        }
+        const size_t start = inside ? state.index + 1 : 0;
+        for (size_t i = 0; i < worker_count; ++i) {
+            if (workers[(start + i) % worker_count].tasks.steal(task))
+                return taken( );
+        }
+        return false;
+    }
+
+    bool taken( )
+    {
+        queued.fetch_sub(1);
+        return true;
+    }
+
+    // run other tasks until task is done
+    void wait(__pool_task *task)
+    {
+        while (!task->done.load(std::memory_order_acquire)) {
+            __pool_task *other;
+            if (find_task(other))
+                execute(other);
+            else
+                std::this_thread::yield( );
+        }
+    }
+
+    void work(size_t index)
+    {
+        thread_state &state = local_state( );
+        state.pool = this;
+        state.index = index;
+
+        while (true) {
+            __pool_task *task;
+            if (find_task(task)) {
+                execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(sleep_lock);
+            sleepers.fetch_add(1);
+            wake_up.wait(guard, [this]( ) { return stopping || queued.load( ) != 0; });
+            sleepers.fetch_sub(1);
+            if (stopping)
+                return;
+        }
+    }
+
+private:
+    size_t worker_count;
+    worker *workers;
+
+    std::mutex sleep_lock;
+    std::condition_variable wake_up;
+    bool stopping;
+    // the number of tasks waiting in the deques and the shared queue
+    std::atomic<size_t> queued;
+    std::atomic<size_t> sleepers;
+
+    // the tasks forked from outside the pool
+    std::mutex inject_lock;
+    deque<__pool_task *, multithread_alloc> injected;
+    std::atomic<size_t> injected_count;
+};
+
+// The result of thread_pool::fork. join( ) waits for the task, running other
+// tasks meanwhile, and rethrows its exception.
+template <typename F>
+class task_handle {
+private:
+    typedef __pool_task_of<F> task_type;
+    typedef simple_alloc<task_type, multithread_alloc> task_allocator;
+
+public:
+    task_handle(task_handle &&other) : pool(other.pool), task(other.task) { other.task = 0; }
+
+    ~task_handle( )
+    {
+        if (task) {
+            pool->wait(task);
+            release( );
+        }
+    }
+
+    bool joinable( ) const { return task != 0; }
+
+    bool ready( ) const { return task->done.load(std::memory_order_acquire); }
+
+    void join( )
+    {
+        pool->wait(task);
+        std::exception_ptr error = task->error;
+        release( );
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    friend class thread_pool;
+
+    task_handle(thread_pool *p, task_type *t) : pool(p), task(t) { }
+    task_handle(const task_handle &);
+    task_handle &operator=(const task_handle &);
+
+    void release( )
+    {
+        destory(task);
+        task_allocator::deallocate(task);
+        task = 0;
+    }
+
+private:
+    thread_pool *pool;
+    task_type *task;
+};
+
+template <typename F>
+task_handle<typename std::decay<F>::type> thread_pool::fork(F &&f)
+{
+    typedef __pool_task_of<typename std::decay<F>::type> task_type;
+    typedef simple_alloc<task_type, multithread_alloc> task_allocator;
+    task_type *task = task_allocator::allocate( );
+    try {
+        construct(task, std::forward<F>(f));
+    } catch (...) {
+        task_allocator::deallocate(task);
+        throw;
+    }
+    submit(task);
+    return task_handle<typename std::decay<F>::type>(this, task);
+}
+
+// parallel_for on the default pool
+template <typename RandomAccessIterator, typename Body>
+inline void parallel_for(RandomAccessIterator first, RandomAccessIterator last, const Body &body,
+                         size_t grain = 0)
+{
+    thread_pool::default_pool( ).parallel_for(first, last, body, grain);
+}
+
+} // namespace ministl
+
+#endif // MINISTL_THREAD_POOL_H
@@ -1,155 +1,53 @@
 #ifndef MINISTL_TYPE_TRAITS_H
 #define MINISTL_TYPE_TRAITS_H
 
+#include <type_traits>
+
 namespace ministl {
 
 struct true_type { };
 struct false_type { };
 
-template <typename type>
-struct type_traits {
-  typedef true_type  this_dummy_member_must_be_first;
-  typedef false_type has_trivial_copy_constructor;
-  typedef false_type has_trivial_assignment_operator;
-  typedef false_type has_trivial_destructor;
-  typedef false_type is_POD_type;
-};
-
-template<> struct type_traits<bool> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<char> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<signed char> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<unsigned char> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<wchar_t> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<short> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<unsigned short> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
+// map a compile time condition to true_type or false_type
+template <bool value>
+struct bool_type {
+  typedef false_type type;
 };
 
-template<> struct type_traits<int> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
+template <>
+struct bool_type<true> {
+  typedef true_type type;
 };
 
-template<> struct type_traits<unsigned int> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<long> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<unsigned long> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<long long> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<unsigned long long> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<float> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<double> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
-};
-
-template<> struct type_traits<long double> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
+// the flags are derived from the compiler, so builtin types, pointers and
+// user structs without user provided special members all take the
+// memmove, memset and no destructor paths of the algorithms
+template <typename type>
+struct type_traits {
+  typedef true_type  this_dummy_member_must_be_first;
+  typedef typename bool_type<std::is_trivially_copy_constructible<type>::value>::type
+    has_trivial_copy_constructor;
+  typedef typename bool_type<std::is_trivially_copy_assignable<type>::value>::type
+    has_trivial_assignment_operator;
+  typedef typename bool_type<std::is_trivially_destructible<type>::value>::type
+    has_trivial_destructor;
+  typedef typename bool_type<std::is_trivial<type>::value>::type is_POD_type;
+};
+
+// type is true_type when an object of type T may be moved to another address
+// with memcpy, its old copy being dropped without running its destructor.
+// Trivially copyable types are, other types may opt in by specializing it:
+//   template <> struct is_trivially_relocatable<my_handle> { typedef true_type type; };
+template <typename T>
+struct is_trivially_relocatable {
+  typedef typename bool_type<std::is_trivially_copyable<T>::value>::type type;
 };
 
+// integral is true_type for the integer types, the range members of the
+// containers use it to tell (n, value) arguments from a pair of iterators
 template <typename T>
-struct type_traits<T*> {
-  typedef true_type this_dummy_member_must_be_first;
-  typedef true_type has_trivial_copy_constructor;
-  typedef true_type has_trivial_assignment_operator;
-  typedef true_type has_trivial_destructor;
-  typedef true_type is_POD_type;
+struct is_integer {
+  typedef typename bool_type<std::is_integral<T>::value>::type integral;
 };
 
 } // namespace ministl
@@ -72,9 +72,115 @@ inline ForwardIterator __uninitialized_copy_aux(InputItertor first, InputItertor
     return cur;
 }
 
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator __uninitialized_move_aux(InputIterator first, InputIterator last,
+                                                ForwardIterator result, true_type)
+{
+    return copy(first, last, result);
+}
+
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator __uninitialized_move_aux(InputIterator first, InputIterator last,
+                                                ForwardIterator result, false_type)
+{
+    ForwardIterator cur = result;
+    try {
+        for (; first != last; ++first, ++cur)
+            construct(&*cur, std::move(*first));
+    } catch (...) {
+        destory(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <typename InputIterator, typename ForwardIterator, typename T>
+inline ForwardIterator __uninitialized_move(InputIterator first, InputIterator last,
+                                            ForwardIterator result, T*)
+{
+    typedef typename type_traits<T>::is_POD_type is_POD;
+    return __uninitialized_move_aux(first, last, result, is_POD( ));
+}
+
+// uninitialized_move moves the elements of [first, last) into raw memory,
+// the elements built so far are destroyed when a move constructor throws
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator uninitialized_move(InputIterator first, InputIterator last,
+                                          ForwardIterator result)
+{
+    return __uninitialized_move(first, last, result, value_type(result));
+}
+
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator __uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last,
+                                                            ForwardIterator result, true_type)
+{
+    return copy(first, last, result);
+}
+
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator __uninitialized_move_if_noexcept_aux(InputIterator first, InputIterator last,
+                                                            ForwardIterator result, false_type)
+{
+    ForwardIterator cur = result;
+    try {
+        for (; first != last; ++first, ++cur)
+            construct(&*cur, std::move_if_noexcept(*first));
+    } catch (...) {
+        destory(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <typename InputIterator, typename ForwardIterator, typename T>
+inline ForwardIterator __uninitialized_move_if_noexcept(InputIterator first, InputIterator last,
+                                                        ForwardIterator result, T*)
+{
+    typedef typename type_traits<T>::is_POD_type is_POD;
+    return __uninitialized_move_if_noexcept_aux(first, last, result, is_POD( ));
+}
+
+// like uninitialized_move, but copies the elements whose move constructor
+// may throw, which keeps [first, last) intact if an exception is thrown
+template <typename InputIterator, typename ForwardIterator>
+inline ForwardIterator uninitialized_move_if_noexcept(InputIterator first, InputIterator last,
+                                                      ForwardIterator result)
+{
+    return __uninitialized_move_if_noexcept(first, last, result, value_type(result));
+}
+
+template <typename T>
+inline T* __uninitialized_relocate_aux(T *first, T *last, T *result, true_type)
+{
+    if (first != last)
+        memcpy((void*)result, (const void*)first, sizeof(T) * (last - first));
+    return result + (last - first);
+}
+
+template <typename T>
+inline T* __uninitialized_relocate_aux(T *first, T *last, T *result, false_type)
+{
+    T *cur = uninitialized_move_if_noexcept(first, last, result);
+    destory(first, last);
+    return cur;
+}
+
+// uninitialized_relocate moves [first, last) into the raw memory at result
+// and ends the lifetime of the source elements, which must not be destroyed
+// afterwards. Trivially relocatable elements are copied with memcpy and no
+// destructor runs. If an exception is thrown [first, last) is left intact.
+template <typename T>
+inline T* uninitialized_relocate(T *first, T *last, T *result)
+{
+    typedef typename is_trivially_relocatable<T>::type relocatable;
+    return __uninitialized_relocate_aux(first, last, result, relocatable( ));
+}
+
 inline char* uninitialized_copy(const char *first, const char *last, char *result)
 {
     memmove(result, first, last - first);
+    return result + (last - first);
 }
 
 inline wchar_t* uninitialized_copy(const wchar_t *first, const wchar_t *last, wchar_t *result)
@@ -2,15 +2,51 @@
 #define MINISTL_VECTOR_H
 
 #include <stddef.h>
+#include <utility>
 #include "alloc.h"
 #include "algorithm.h"
 #include "construct.h"
+#include "type_traits.h"
 #include "uninitialized.h"
 
 namespace ministl {
 
-template <typename T, class Alloc = alloc>
-class vector {
+// Growth policies of vector. grow<T, Alloc>(capacity, required) returns the
+// capacity a vector of capacity elements grows to when it needs room for
+// required elements, which is at least required.
+struct vector_double_growth {
+  template <typename T, typename Alloc>
+  static size_t grow(size_t capacity, size_t required)
+  {
+    const size_t len = capacity != 0 ? 2 * capacity : 1;
+    return len < required ? required : len;
+  }
+};
+
+// grow by half of the capacity, the freed blocks may then be reused
+struct vector_half_growth {
+  template <typename T, typename Alloc>
+  static size_t grow(size_t capacity, size_t required)
+  {
+    const size_t len = capacity + capacity / 2 + 1;
+    return len < required ? required : len;
+  }
+};
+
+// grow as Base does, then round the capacity up to fill the block the
+// allocator really provides, Alloc must have a static good_size
+template <typename Base = vector_double_growth>
+struct vector_size_class_growth {
+  template <typename T, typename Alloc>
+  static size_t grow(size_t capacity, size_t required)
+  {
+    const size_t len = Base::template grow<T, Alloc>(capacity, required);
+    return Alloc::good_size(len * sizeof(T)) / sizeof(T);
+  }
+};
+
+template <typename T, class Alloc = alloc, class GrowthPolicy = vector_double_growth>
+class vector : protected alloc_holder<Alloc> {
 public:
   typedef T                 value_type;
   typedef value_type*       iterator;
@@ -21,20 +57,40 @@ public:
   typedef const value_type& const_reference;
   typedef size_t            size_type;
   typedef ptrdiff_t         difference_type;
+  typedef Alloc             allocator_type;
 
 public:
   vector( ) : start(0), finish(0), end_of_storage(0) { }
-  vector(size_type n, const T& value) { fill_initialize(n, value); }
-  vector(int n, const T& value) { fill_initialize(n, value); }
-  vector(long n, const T& value) { fill_initialize(n, value); }
-  explicit vector(size_type n) { fill_initialize(n, T( )); }
+  explicit vector(const Alloc& a) : alloc_holder<Alloc>(a), start(0), finish(0), end_of_storage(0) { }
+  vector(size_type n, const T& value, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a) { fill_initialize(n, value); }
+  vector(int n, const T& value, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a) { fill_initialize(n, value); }
+  vector(long n, const T& value, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a) { fill_initialize(n, value); }
+  explicit vector(size_type n, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a) { fill_initialize(n, T( )); }
 
+  // a range which can be traversed twice is measured first and allocated at once
   template <typename InputIterator>
-  vector(InputIterator first, InputIterator last)
+  vector(InputIterator first, InputIterator last, const Alloc& a = Alloc( ))
+    : alloc_holder<Alloc>(a), start(0), finish(0), end_of_storage(0)
   {
-    for (; first != last; ++first) {
-      push_back(*first);
-    }
+    typedef typename is_integer<InputIterator>::integral integral;
+    initialize_dispatch(first, last, integral( ));
+  }
+
+  vector(const vector& x) : alloc_holder<Alloc>(x.get_allocator( ))
+  {
+    range_initialize(x.begin( ), x.end( ), random_access_iterator_tag( ));
+  }
+
+  // the storage of x is taken over, x is left empty
+  vector(vector&& x) noexcept
+    : alloc_holder<Alloc>(x.get_allocator( )),
+      start(x.start), finish(x.finish), end_of_storage(x.end_of_storage)
+  {
+    x.start = x.finish = x.end_of_storage = 0;
   }
 
   ~vector( )
@@ -43,6 +99,32 @@ public:
     deallocate( );
   }
 
+  vector& operator=(const vector& x)
+  {
+    if (this != &x)
+      assign(x.begin( ), x.end( ));
+    return *this;
+  }
+
+  vector& operator=(vector&& x) noexcept
+  {
+    if (this != &x) {
+      vector tmp(std::move(x));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  void swap(vector& x)
+  {
+    ministl::swap(start, x.start);
+    ministl::swap(finish, x.finish);
+    ministl::swap(end_of_storage, x.end_of_storage);
+    ministl::swap(this->allocator_ref( ), x.allocator_ref( ));
+  }
+
+  allocator_type get_allocator( ) const { return this->allocator_ref( ); }
+
   iterator  begin( ) { return start; }
   const_iterator begin( ) const { return start; }
   iterator  end( ) { return finish; }
@@ -55,14 +137,53 @@ public:
   size_type capacity( ) const { return (size_type)(end_of_storage - start); }
   bool empty( ) const { return begin( ) == end( ); }
   reference operator[](size_type n) { return *(begin( ) + n); }
+  const_reference operator[](size_type n) const { return *(begin( ) + n); }
+
+  void push_back(const T &x) { emplace_back(x); }
+  void push_back(T &&x) { emplace_back(std::move(x)); }
 
-  void push_back(const T &x)
+  // construct an element at the end from args
+  template <typename... Args>
+  void emplace_back(Args&&... args)
   {
     if (finish != end_of_storage) {
-      construct(finish, x);
+      construct(finish, std::forward<Args>(args)...);
       ++finish;
     } else
-      insert_aux(end( ), x);
+      emplace_aux(end( ), std::forward<Args>(args)...);
+  }
+
+  // construct an element from args before position
+  template <typename... Args>
+  iterator emplace(iterator position, Args&&... args)
+  {
+    const size_type n = position - begin( );
+    if (finish != end_of_storage && position == end( )) {
+      construct(finish, std::forward<Args>(args)...);
+      ++finish;
+    } else
+      emplace_aux(position, std::forward<Args>(args)...);
+    return begin( ) + n;
+  }
+
+  iterator insert(iterator position, const T &x) { return emplace(position, x); }
+  iterator insert(iterator position, T &&x) { return emplace(position, std::move(x)); }
+
+  template <typename InputIterator>
+  void insert(iterator position, InputIterator first, InputIterator last)
+  {
+    typedef typename is_integer<InputIterator>::integral integral;
+    insert_dispatch(position, first, last, integral( ));
+  }
+
+  // replace the elements with n copies of x or with the range [first, last)
+  void assign(size_type n, const T &x);
+
+  template <typename InputIterator>
+  void assign(InputIterator first, InputIterator last)
+  {
+    typedef typename is_integer<InputIterator>::integral integral;
+    assign_dispatch(first, last, integral( ));
   }
 
   void pop_back( )
@@ -74,7 +195,7 @@ public:
   iterator erase(iterator position)
   {
     if (position + 1 != end( ))
-      copy(position + 1, finish, position);
+      ministl::move(position + 1, finish, position);
     --finish;
     destory(finish);
     return position;
@@ -82,12 +203,26 @@ public:
 
   iterator erase(iterator first, iterator last)
   {
-    iterator i = copy(last, finish, first);
+    iterator i = ministl::move(last, finish, first);
     destory(i, finish);
     finish = finish - (last - first);
     return first;
   }
 
+  // make room for n elements without growing again
+  void reserve(size_type n)
+  {
+    if (n > capacity( ))
+      relocate_storage(n, relocatable( ));
+  }
+
+  // give the unused capacity back to the allocator
+  void shrink_to_fit( )
+  {
+    if (finish != end_of_storage)
+      relocate_storage(size( ), relocatable( ));
+  }
+
   void resize(size_type new_size, const T& x)
   {
     if (new_size < size( ))
@@ -105,15 +240,56 @@ protected:
   iterator finish;
   iterator end_of_storage;
 
-  void insert_aux(iterator position, const T& x);
+  // trivially relocatable elements may be moved bitwise, the storage then
+  // grows through the reallocate of the allocator, in place when it can
+  typedef typename is_trivially_relocatable<T>::type relocatable;
+
+  template <typename... Args>
+  void emplace_aux(iterator position, Args&&... args);
+  template <typename... Args>
+  void grow_and_emplace(iterator position, size_type len, true_type, Args&&... args);
+  template <typename... Args>
+  void grow_and_emplace(iterator position, size_type len, false_type, Args&&... args);
+  void grow_and_insert(iterator position, size_type n, const T& x, size_type len, true_type);
+  void grow_and_insert(iterator position, size_type n, const T& x, size_type len, false_type);
+
+  void reallocate_storage(size_type len)
+  {
+    const size_type old_size = size( );
+    start = data_allocator::reallocate(this->allocator_ref( ), start, capacity( ), len);
+    finish = start + old_size;
+    end_of_storage = start + len;
+  }
+
+  // move the elements to a storage of len elements
+  void relocate_storage(size_type len, true_type) { reallocate_storage(len); }
+  void relocate_storage(size_type len, false_type);
+
+  size_type grow_capacity(size_type required) const
+  {
+    return GrowthPolicy::template grow<T, Alloc>(capacity( ), required);
+  }
 
   iterator allocate_and_fill(size_type n, const T &x)
   {
-    iterator result = data_allocator::allocate(n);
+    iterator result = data_allocator::allocate(this->allocator_ref( ), n);
     ministl::uninitialized_fill_n(result, n, x);
     return result;
   }
 
+  template <typename ForwardIterator>
+  iterator allocate_and_copy(size_type n, ForwardIterator first, ForwardIterator last)
+  {
+    iterator result = data_allocator::allocate(this->allocator_ref( ), n);
+    try {
+      ministl::uninitialized_copy(first, last, result);
+    } catch (...) {
+      data_allocator::deallocate(this->allocator_ref( ), result, n);
+      throw;
+    }
+    return result;
+  }
+
   void fill_initialize(size_type n, const T &value)
   {
     start = allocate_and_fill(n, value);
@@ -121,51 +297,291 @@ protected:
     end_of_storage = finish;
   }
 
+  template <typename Integer>
+  void initialize_dispatch(Integer n, Integer value, true_type)
+  {
+    fill_initialize(n, value);
+  }
+
+  template <typename InputIterator>
+  void initialize_dispatch(InputIterator first, InputIterator last, false_type)
+  {
+    typedef typename iterator_traits<InputIterator>::iterator_category category;
+    range_initialize(first, last, category( ));
+  }
+
+  template <typename InputIterator>
+  void range_initialize(InputIterator first, InputIterator last, input_iterator_tag)
+  {
+    for (; first != last; ++first)
+      emplace_back(*first);
+  }
+
+  template <typename ForwardIterator>
+  void range_initialize(ForwardIterator first, ForwardIterator last, forward_iterator_tag)
+  {
+    const size_type n = ministl::distance(first, last);
+    start = allocate_and_copy(n, first, last);
+    finish = start + n;
+    end_of_storage = finish;
+  }
+
+  template <typename Integer>
+  void insert_dispatch(iterator position, Integer n, Integer x, true_type)
+  {
+    insert(position, size_type(n), T(x));
+  }
+
+  template <typename InputIterator>
+  void insert_dispatch(iterator position, InputIterator first, InputIterator last, false_type)
+  {
+    typedef typename iterator_traits<InputIterator>::iterator_category category;
+    range_insert(position, first, last, category( ));
+  }
+
+  template <typename InputIterator>
+  void range_insert(iterator position, InputIterator first, InputIterator last,
+                    input_iterator_tag)
+  {
+    for (; first != last; ++first, ++position)
+      position = insert(position, *first);
+  }
+
+  template <typename ForwardIterator>
+  void range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                    forward_iterator_tag);
+  template <typename ForwardIterator>
+  void grow_and_range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                             size_type len, true_type);
+  template <typename ForwardIterator>
+  void grow_and_range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                             size_type len, false_type);
+
+  template <typename Integer>
+  void assign_dispatch(Integer n, Integer x, true_type) { assign(size_type(n), T(x)); }
+
+  template <typename InputIterator>
+  void assign_dispatch(InputIterator first, InputIterator last, false_type)
+  {
+    typedef typename iterator_traits<InputIterator>::iterator_category category;
+    range_assign(first, last, category( ));
+  }
+
+  template <typename InputIterator>
+  void range_assign(InputIterator first, InputIterator last, input_iterator_tag);
+  template <typename ForwardIterator>
+  void range_assign(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+
   void deallocate( )
   {
     if (start)
-      data_allocator::deallocate(start, end_of_storage - start);
+      data_allocator::deallocate(this->allocator_ref( ), start, end_of_storage - start);
   }
 };
 
-template <typename T, typename Alloc>
-void vector<T, Alloc>::insert_aux(iterator position, const T &x)
+template <typename T, typename Alloc, typename GrowthPolicy>
+void vector<T, Alloc, GrowthPolicy>::relocate_storage(size_type len, false_type)
+{
+  iterator new_start = data_allocator::allocate(this->allocator_ref( ), len);
+  iterator new_finish;
+  try {
+    new_finish = ministl::uninitialized_relocate(start, finish, new_start);
+  } catch (...) {
+    data_allocator::deallocate(this->allocator_ref( ), new_start, len);
+    throw;
+  }
+  deallocate( );
+  start = new_start;
+  finish = new_finish;
+  end_of_storage = start + len;
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void vector<T, Alloc, GrowthPolicy>::assign(size_type n, const T &x)
+{
+  if (n > capacity( )) {
+    vector tmp(n, x, get_allocator( ));
+    swap(tmp);
+  } else if (n > size( )) {
+    ministl::fill(begin( ), end( ), x);
+    finish = ministl::uninitialized_fill_n(finish, n - size( ), x);
+  } else {
+    erase(ministl::fill_n(begin( ), n, x), end( ));
+  }
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename InputIterator>
+void vector<T, Alloc, GrowthPolicy>::range_assign(InputIterator first, InputIterator last,
+                                                  input_iterator_tag)
+{
+  iterator cur = begin( );
+  for (; first != last && cur != end( ); ++first, ++cur)
+    *cur = *first;
+  if (first == last)
+    erase(cur, end( ));
+  else
+    insert(end( ), first, last);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename ForwardIterator>
+void vector<T, Alloc, GrowthPolicy>::range_assign(ForwardIterator first, ForwardIterator last,
+                                                  forward_iterator_tag)
+{
+  const size_type len = ministl::distance(first, last);
+  if (len > capacity( )) {
+    iterator tmp = allocate_and_copy(len, first, last);
+    destory(start, finish);
+    deallocate( );
+    start = tmp;
+    finish = end_of_storage = start + len;
+  } else if (size( ) >= len) {
+    iterator new_finish = ministl::copy(first, last, start);
+    destory(new_finish, finish);
+    finish = new_finish;
+  } else {
+    ForwardIterator mid = first;
+    ministl::advance(mid, size( ));
+    ministl::copy(first, mid, start);
+    finish = ministl::uninitialized_copy(mid, last, finish);
+  }
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename ForwardIterator>
+void vector<T, Alloc, GrowthPolicy>::range_insert(iterator position, ForwardIterator first,
+                                                  ForwardIterator last, forward_iterator_tag)
+{
+  if (first == last)
+    return;
+  const size_type n = ministl::distance(first, last);
+  if (size_type(end_of_storage - finish) >= n) {
+    const size_type elems_after = finish - position;
+    iterator old_finish = finish;
+
+    if (elems_after > n) {
+      ministl::uninitialized_move(finish - n, finish, finish);
+      finish += n;
+      ministl::move_backward(position, old_finish - n, old_finish);
+      ministl::copy(first, last, position);
+    } else {
+      ForwardIterator mid = first;
+      ministl::advance(mid, elems_after);
+      ministl::uninitialized_copy(mid, last, finish);
+      finish += n - elems_after;
+      ministl::uninitialized_move(position, old_finish, finish);
+      finish += elems_after;
+      ministl::copy(first, mid, position);
+    }
+  } else {
+    grow_and_range_insert(position, first, last, grow_capacity(size( ) + n), relocatable( ));
+  }
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename ForwardIterator>
+void vector<T, Alloc, GrowthPolicy>::grow_and_range_insert(iterator position, ForwardIterator first,
+                                                           ForwardIterator last, size_type len,
+                                                           true_type)
+{
+  const size_type offset = position - start;
+  reallocate_storage(len);
+  range_insert(start + offset, first, last, forward_iterator_tag( ));
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename ForwardIterator>
+void vector<T, Alloc, GrowthPolicy>::grow_and_range_insert(iterator position, ForwardIterator first,
+                                                           ForwardIterator last, size_type len,
+                                                           false_type)
+{
+  iterator new_start = data_allocator::allocate(this->allocator_ref( ), len);
+  iterator new_finish = new_start;
+  try {
+    new_finish = ministl::uninitialized_move_if_noexcept(start, position, new_start);
+    new_finish = ministl::uninitialized_copy(first, last, new_finish);
+    new_finish = ministl::uninitialized_move_if_noexcept(position, finish, new_finish);
+  } catch (...) {
+    destory(new_start, new_finish);
+    data_allocator::deallocate(this->allocator_ref( ), new_start, len);
+    throw;
+  }
+  destory(start, finish);
+  deallocate( );
+  start = new_start;
+  finish = new_finish;
+  end_of_storage = start + len;
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename... Args>
+void vector<T, Alloc, GrowthPolicy>::emplace_aux(iterator position, Args&&... args)
 {
   if (finish != end_of_storage) {
-    construct(finish, *(finish - 1));
+    // args may refer to an element about to move
+    T x_copy(std::forward<Args>(args)...);
+    construct(finish, std::move(*(finish - 1)));
     ++finish;
+    ministl::move_backward(position, finish - 2, finish - 1);
+    *position = std::move(x_copy);
+  } else {
+    grow_and_emplace(position, grow_capacity(size( ) + 1), relocatable( ),
+                     std::forward<Args>(args)...);
+  }
+}
 
-    T x_copy = x;
-    copy_backward(position, finish - 2, finish - 1);
-    *position = x_copy;
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename... Args>
+void vector<T, Alloc, GrowthPolicy>::grow_and_emplace(iterator position, size_type len, true_type,
+                                        Args&&... args)
+{
+  T x_copy(std::forward<Args>(args)...);
+  const size_type offset = position - start;
+  reallocate_storage(len);
+  if (start + offset == finish) {
+    construct(finish, std::move(x_copy));
+    ++finish;
   } else {
-    const size_type old_size = size( );
-    const size_type len = (old_size != 0 ? 2 * old_size : 1);
+    emplace_aux(start + offset, std::move(x_copy));
+  }
+}
 
-    iterator new_start = data_allocator::allocate(len);
-    iterator new_finish = new_start;
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <typename... Args>
+void vector<T, Alloc, GrowthPolicy>::grow_and_emplace(iterator position, size_type len, false_type,
+                                        Args&&... args)
+{
+  iterator new_start = data_allocator::allocate(this->allocator_ref( ), len);
+  iterator new_position = new_start + (position - start);
+  iterator new_finish = new_start;
+  bool constructed = false;
 
-    try {
-      new_finish = uninitialized_copy(start, position, new_start);
-      construct(new_finish, x);
-      ++new_finish;
-      new_finish = uninitialized_copy(position, finish, new_finish);
-    } catch (...) {
-      // "commit or rollback" semantics
+  try {
+    // the new element goes first, args may refer to an element about to move
+    construct(new_position, std::forward<Args>(args)...);
+    constructed = true;
+    new_finish = ministl::uninitialized_move_if_noexcept(start, position, new_start);
+    ++new_finish;
+    new_finish = ministl::uninitialized_move_if_noexcept(position, finish, new_finish);
+  } catch (...) {
+    // "commit or rollback" semantics
+    if (new_finish != new_start)
       destory(new_start, new_finish);
-      data_allocator::deallocate(new_start, len);
-      throw;
-    }
-    destory(begin( ), end( ));
-    deallocate( );
-    start = new_start;
-    finish = new_finish;
-    end_of_storage = new_start + len;
+    else if (constructed)
+      destory(new_position);
+    data_allocator::deallocate(this->allocator_ref( ), new_start, len);
+    throw;
   }
+  destory(begin( ), end( ));
+  deallocate( );
+  start = new_start;
+  finish = new_finish;
+  end_of_storage = new_start + len;
 }
 
-template <typename T, typename Alloc>
-void vector<T, Alloc>::insert(iterator position, size_type n, const T &x)
+template <typename T, typename Alloc, typename GrowthPolicy>
+void vector<T, Alloc, GrowthPolicy>::insert(iterator position, size_type n, const T &x)
 {
   if (n != 0) {
     if (size_type(end_of_storage - finish) >= n) {
@@ -174,41 +590,55 @@ void vector<T, Alloc>::insert(iterator position, size_type n, const T &x)
       iterator old_finish = finish;
 
       if (elems_after > n) {
-        uninitialized_copy(finish - n, finish, finish);
+        ministl::uninitialized_move(finish - n, finish, finish);
         finish += n;
-        copy_backward(position, old_finish - n, old_finish);
-        fill(position, position + n, x_copy);
+        ministl::move_backward(position, old_finish - n, old_finish);
+        ministl::fill(position, position + n, x_copy);
       } else {
-        uninitialized_fill_n(finish, n - elems_after, x_copy);
+        ministl::uninitialized_fill_n(finish, n - elems_after, x_copy);
         finish += n - elems_after;
-        uninitialized_copy(position, old_finish, finish);
+        ministl::uninitialized_move(position, old_finish, finish);
         finish += elems_after;
-        fill(position, old_finish, x_copy);
+        ministl::fill(position, old_finish, x_copy);
       }
     } else {
-      const size_type old_size = size( );
-      const size_type len = old_size + max(old_size, n);
-
-      iterator new_start = data_allocator::allocate(len);
-      iterator new_finish = new_start;
-      try {
-        new_finish = uninitialized_copy(start, position, new_start);
-        new_finish = uninitialized_fill_n(new_finish, n, x);
-        new_finish = uninitialized_copy(position, finish, new_finish);
-      } catch (...) {
-        destory(new_start, new_finish);
-        data_allocator::deallocate(new_start, len);
-        throw;
-      }
-      destory(start, finish);
-      deallocate( );
-      start = new_start;
-      finish = new_finish;
-      end_of_storage = start + len;
+      grow_and_insert(position, n, x, grow_capacity(size( ) + n), relocatable( ));
     }
   }
 }
 
+template <typename T, typename Alloc, typename GrowthPolicy>
+void vector<T, Alloc, GrowthPolicy>::grow_and_insert(iterator position, size_type n, const T &x,
+                                       size_type len, true_type)
+{
+  T x_copy = x;
+  const size_type offset = position - start;
+  reallocate_storage(len);
+  insert(start + offset, n, x_copy);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void vector<T, Alloc, GrowthPolicy>::grow_and_insert(iterator position, size_type n, const T &x,
+                                       size_type len, false_type)
+{
+  iterator new_start = data_allocator::allocate(this->allocator_ref( ), len);
+  iterator new_finish = new_start;
+  try {
+    new_finish = ministl::uninitialized_move_if_noexcept(start, position, new_start);
+    new_finish = ministl::uninitialized_fill_n(new_finish, n, x);
+    new_finish = ministl::uninitialized_move_if_noexcept(position, finish, new_finish);
+  } catch (...) {
+    destory(new_start, new_finish);
+    data_allocator::deallocate(this->allocator_ref( ), new_start, len);
+    throw;
+  }
+  destory(start, finish);
+  deallocate( );
+  start = new_start;
+  finish = new_finish;
+  end_of_storage = start + len;
+}
+
 } // namespace ministl
 
-#endif // MINISTL_VECTOR_H 
\ No newline at end of file
+#endif // MINISTL_VECTOR_H
@@ -1,3 +1,5 @@
+#include <thread>
+#include <vector>
 #include "alloc.h"
 #include "gtest/gtest.h"
 
@@ -41,4 +43,269 @@ TEST(DefaultAllocTemplateTEST, allocate_deallocate_reallocate_test)
   allocator.deallocate(double_value, sizeof(double));
 }
 
-} // namespace ministl
\ No newline at end of file
+TEST(DefaultAllocTemplateTEST, multithread_allocate_deallocate_test)
+{
+  const int thread_nums = 8;
+  const int test_times = 10000;
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < thread_nums; ++t) {
+    workers.emplace_back([t, test_times]( ) {
+      for (int i = 0; i < test_times; ++i) {
+        size_t n = (i % MAX_BYTES) + 1;
+        char* p = (char*)multithread_alloc::allocate(n);
+        memset(p, t, n);
+        for (size_t j = 0; j < n; ++j)
+          EXPECT_EQ(char(t), p[j]);
+        multithread_alloc::deallocate(p, n);
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join( );
+}
+
+TEST(DefaultAllocTemplateTEST, multithread_cross_thread_deallocate_test)
+{
+  const int test_times = 1000;
+  std::vector<void*> blocks(test_times);
+
+  std::thread producer([&blocks]( ) {
+    for (auto& p : blocks)
+      p = multithread_alloc::allocate(sizeof(double));
+  });
+  producer.join( );
+
+  std::thread consumer([&blocks]( ) {
+    for (auto p : blocks)
+      multithread_alloc::deallocate(p, sizeof(double));
+  });
+  consumer.join( );
+
+  void* p = multithread_alloc::allocate(sizeof(double));
+  EXPECT_NE(nullptr, p);
+  multithread_alloc::deallocate(p, sizeof(double));
+}
+
+TEST(DefaultAllocTemplateTEST, release_unused_test)
+{
+  typedef default_alloc_template<false, 1> pool;
+  const int test_times = 10000;
+  std::vector<void*> blocks(test_times);
+
+  for (auto& p : blocks)
+    p = pool::allocate(32);
+  int* live = (int*)pool::allocate(sizeof(int));
+  *live = test_times;
+  for (auto p : blocks)
+    pool::deallocate(p, 32);
+
+  EXPECT_GT(pool::release_unused( ), 0u);
+  EXPECT_EQ(0u, pool::release_unused( ));
+  EXPECT_EQ(test_times, *live);
+
+  void* p = pool::allocate(32);
+  EXPECT_NE(nullptr, p);
+  pool::deallocate(p, 32);
+  pool::deallocate(live, sizeof(int));
+}
+
+TEST(DefaultAllocTemplateTEST, multithread_release_unused_test)
+{
+  typedef default_alloc_template<true, 1> pool;
+  const int test_times = 1000;
+
+  std::thread worker([test_times]( ) {
+    std::vector<void*> blocks(test_times);
+    for (auto& p : blocks)
+      p = pool::allocate(64);
+    for (auto p : blocks)
+      pool::deallocate(p, 64);
+  });
+  worker.join( );
+  EXPECT_GT(pool::release_unused( ), 0u);
+}
+
+TEST(DefaultAllocTemplateTEST, stats_test)
+{
+  typedef default_alloc_template<false, 2> pool;
+  alloc_stats stats;
+
+  pool::get_stats(stats);
+  EXPECT_EQ(0u, stats.heap_size);
+  EXPECT_EQ(0u, stats.chunk_count);
+  EXPECT_EQ(size_t(MAX_BYTES), stats.classes[NFREELISTS - 1].object_size);
+
+  void* small = pool::allocate(16);
+  void* large = pool::allocate(MAX_BYTES + 1);
+  pool::get_stats(stats);
+  EXPECT_EQ(1u, stats.chunk_count);
+  EXPECT_GT(stats.heap_size, 0u);
+  EXPECT_GT(stats.classes[1].free_bytes, 0u);
+#ifdef MINISTL_ALLOC_STATS
+  EXPECT_EQ(1u, stats.classes[1].allocations);
+  EXPECT_EQ(1u, stats.classes[1].live_objects);
+  EXPECT_EQ(1u, stats.large_allocations);
+#endif
+
+  const size_t free_bytes = stats.classes[1].free_bytes;
+  pool::deallocate(small, 16);
+  pool::deallocate(large, MAX_BYTES + 1);
+  pool::get_stats(stats);
+  EXPECT_EQ(free_bytes + 16, stats.classes[1].free_bytes);
+#ifdef MINISTL_ALLOC_STATS
+  EXPECT_EQ(0u, stats.classes[1].live_objects);
+  EXPECT_EQ(1u, stats.large_deallocations);
+#endif
+}
+
+TEST(DefaultAllocTemplateTEST, magazine_stats_test)
+{
+  typedef default_alloc_template<true, 2> pool;
+  alloc_stats stats;
+  size_t cached = 0;
+
+  std::thread worker([&]( ) {
+    void* p = pool::allocate(16);
+    pool::get_stats(stats);
+    cached = stats.classes[1].magazine_bytes;
+    pool::deallocate(p, 16);
+  });
+  worker.join( );
+  EXPECT_GT(cached, 0u);
+  EXPECT_EQ(stats.heap_size,
+            stats.classes[1].free_bytes + stats.classes[1].magazine_bytes + stats.pool_bytes);
+
+  // the magazine of the worker went back to the free list when it exited
+  pool::get_stats(stats);
+  EXPECT_EQ(0u, stats.classes[1].magazine_bytes);
+  EXPECT_EQ(stats.heap_size, stats.classes[1].free_bytes + stats.pool_bytes);
+}
+
+TEST(DefaultAllocTemplateTEST, geometric_size_classes_test)
+{
+  typedef geometric_size_classes<32768> classes;
+  EXPECT_EQ(48u, size_t(classes::nclasses));
+  for (size_t i = 0; i < classes::nclasses; ++i)
+    EXPECT_EQ(i, classes::index(classes::class_size(i)));
+  for (size_t n = 1; n <= classes::max_bytes; ++n) {
+    size_t index = classes::index(n);
+    EXPECT_GE(classes::class_size(index), n);
+    if (index > 0) {
+      EXPECT_LT(classes::class_size(index - 1), n);
+    }
+  }
+  EXPECT_EQ(160u, classes::class_size(classes::index(129)));
+  EXPECT_EQ(320u, classes::class_size(classes::index(257)));
+  EXPECT_EQ(32768u, classes::class_size(classes::nclasses - 1));
+}
+
+TEST(DefaultAllocTemplateTEST, geometric_allocate_deallocate_test)
+{
+  typedef default_alloc_template<false, 3, geometric_size_classes<4096> > pool;
+  const size_t sizes[] = { 8, 100, 129, 200, 500, 1000, 3000, 4096, 5000 };
+  std::vector<char*> blocks;
+
+  for (int round = 0; round < 50; ++round) {
+    for (size_t n : sizes) {
+      char* p = (char*)pool::allocate(n);
+      memset(p, int(n), n);
+      blocks.push_back(p);
+    }
+  }
+  for (size_t i = 0; i < blocks.size( ); ++i) {
+    size_t n = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+    EXPECT_EQ(char(n), blocks[i][n - 1]);
+    pool::deallocate(blocks[i], n);
+  }
+
+  alloc_stats stats;
+  pool::get_stats(stats);
+  EXPECT_EQ(size_t(geometric_size_classes<4096>::nclasses), stats.class_count);
+  EXPECT_GT(pool::release_unused( ), 0u);
+}
+
+TEST(DefaultAllocTemplateTEST, huge_page_chunk_source_test)
+{
+  typedef default_alloc_template<false, 5, sgi_size_classes, huge_page_chunk_source> pool;
+  const size_t huge_page = huge_page_chunk_source::HUGE_PAGE_SIZE;
+  std::vector<void*> blocks;
+
+  for (int i = 0; i < 1000; ++i) {
+    void* p = pool::allocate(64);
+    memset(p, i, 64);
+    blocks.push_back(p);
+  }
+  alloc_stats stats;
+  pool::get_stats(stats);
+  EXPECT_EQ(0u, stats.heap_size % huge_page);
+  for (void* p : blocks)
+    pool::deallocate(p, 64);
+  EXPECT_EQ(stats.heap_size, pool::release_unused( ));
+}
+
+TEST(MallocAllocTemplateTest, huge_page_chunk_source_test)
+{
+  typedef malloc_alloc_template<1, huge_page_chunk_source> huge_alloc;
+  const size_t huge_page = huge_page_chunk_source::HUGE_PAGE_SIZE;
+
+  char* small = (char*)huge_alloc::allocate(100);
+  char* p = (char*)huge_alloc::allocate(huge_page + 1);
+#ifdef __linux__
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(p) % huge_page);
+#endif
+  memset(p, 1, huge_page + 1);
+  p = (char*)huge_alloc::reallocate(p, huge_page + 1, 3 * huge_page);
+  EXPECT_EQ(1, p[huge_page]);
+  p = (char*)huge_alloc::reallocate(p, 3 * huge_page, 100);
+  EXPECT_EQ(1, p[99]);
+  p = (char*)huge_alloc::reallocate(p, 100, 2 * huge_page);
+  EXPECT_EQ(1, p[99]);
+  huge_alloc::deallocate(p, 2 * huge_page);
+  huge_alloc::deallocate(small, 100);
+}
+
+struct alignas(64) cache_line {
+  char bytes[64];
+};
+
+TEST(SimpleAllocTest, over_aligned_allocate_test)
+{
+  typedef simple_alloc<cache_line, alloc> pooled;
+  typedef simple_alloc<cache_line, malloc_alloc> unpooled;
+  typedef simple_alloc<double, alloc, 32> explicitly_aligned;
+
+  cache_line* p = pooled::allocate(3);
+  cache_line* q = unpooled::allocate( );
+  double* d = explicitly_aligned::allocate(5);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(p) % 64);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(q) % 64);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(d) % 32);
+  pooled::deallocate(p, 3);
+  unpooled::deallocate(q);
+  explicitly_aligned::deallocate(d, 5);
+
+  void* r = malloc_alloc::allocate_aligned(100, 128);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(r) % 128);
+  memset(r, 1, 100);
+  r = malloc_alloc::reallocate_aligned(r, 100, 1000, 128);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(r) % 128);
+  EXPECT_EQ(1, static_cast<char*>(r)[99]);
+  malloc_alloc::deallocate_aligned(r, 1000, 128);
+}
+
+TEST(SimpleAllocTest, allocate_deallocate_test)
+{
+  typedef default_alloc_template<false, 4> pool;
+  typedef simple_alloc<int, pool> int_alloc;
+  alloc_stats stats;
+
+  int* p = int_alloc::allocate(4);
+  pool::get_stats(stats);
+  const size_t free_bytes = stats.classes[1].free_bytes;
+  int_alloc::deallocate(p, 4);
+  pool::get_stats(stats);
+  EXPECT_EQ(free_bytes + 4 * sizeof(int), stats.classes[1].free_bytes);
+}
+
+} // namespace ministl
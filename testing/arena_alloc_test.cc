@@ -0,0 +1,50 @@
+#include "arena_alloc.h"
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+TEST(MonotonicArenaTest, allocate_reallocate_release_test)
+{
+  monotonic_arena arena(64);
+  EXPECT_EQ(0u, arena.size( ));
+
+  int* values = (int*)arena.allocate(10 * sizeof(int));
+  for (int i = 0; i < 10; ++i)
+    values[i] = i;
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(values) % ALIGN);
+
+  // the last allocation grows in place
+  int* grown = (int*)arena.reallocate(values, 10 * sizeof(int), 12 * sizeof(int));
+  EXPECT_EQ(values, grown);
+
+  // a reallocation which does not fit is copied into a new block
+  int* moved = (int*)arena.reallocate(grown, 12 * sizeof(int), 1000 * sizeof(int));
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(i, moved[i]);
+
+  void* aligned = arena.allocate_aligned(100, 64);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(aligned) % 64);
+  EXPECT_GT(arena.size( ), 1000 * sizeof(int));
+
+  arena.release( );
+  EXPECT_EQ(0u, arena.size( ));
+  EXPECT_NE(nullptr, arena.allocate(16));
+}
+
+TEST(ArenaAllocTemplateTest, static_interface_test)
+{
+  typedef arena_alloc_template<1> scratch;
+  typedef simple_alloc<double, scratch> double_alloc;
+
+  double* p = double_alloc::allocate(100);
+  for (int i = 0; i < 100; ++i)
+    p[i] = i;
+  double_alloc::deallocate(p, 100);  // a no-op, the memory lives until release( )
+  EXPECT_EQ(99.0, p[99]);
+  EXPECT_GT(scratch::size( ), 0u);
+
+  scratch::release( );
+  EXPECT_EQ(0u, scratch::size( ));
+}
+
+} // namespace ministl
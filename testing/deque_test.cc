@@ -1,5 +1,6 @@
 #include "deque.h"
 #include "functools.h"
+#include "arena_alloc.h"
 #include "gtest/gtest.h"
 
 namespace ministl {
@@ -88,4 +89,21 @@ TEST(DequeTest, insert_test)
   EXPECT_EQ(deque_value + 1, int_que.back( ));
 }
 
-} // namespace leptus
\ No newline at end of file
+TEST(DequeTest, stateful_allocator_test)
+{
+  const int deque_size = 1000;
+  monotonic_arena arena;
+  ministl::deque<int, arena_ref> int_que(deque_size, 1, arena_ref(arena));
+
+  for (int i = 0; i < deque_size; ++i) {
+    int_que.push_front(0);
+    int_que.push_back(2);
+  }
+  EXPECT_EQ(3 * deque_size, int_que.size( ));
+  EXPECT_EQ(0, int_que.front( ));
+  EXPECT_EQ(2, int_que.back( ));
+  EXPECT_EQ(1, int_que[deque_size]);
+  EXPECT_GT(arena.size( ), 3 * deque_size * sizeof(int));
+}
+
+} // namespace leptus
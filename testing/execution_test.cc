@@ -0,0 +1,114 @@
+#include <atomic>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "execution.h"
+#include "list.h"
+#include "vector.h"
+
+namespace ministl {
+
+// large enough to be split over all the threads of the pool
+const size_t COLUMN_SIZE = 1 << 20;
+
+TEST(ExecutionTest, for_each_map_fill_copy_generate_test)
+{
+  vector<long long> column(COLUMN_SIZE);
+  ministl::fill(execution::par, column.begin( ), column.end( ), 3ll);
+  EXPECT_EQ(3 * (long long)COLUMN_SIZE, ministl::accumulate(column.begin( ), column.end( ), 0ll));
+
+  std::atomic<size_t> next(0);
+  ministl::generate(execution::par_unseq, column.begin( ), column.end( ),
+                    [&]( ) { return (long long)next.fetch_add(1) % 7; });
+  EXPECT_EQ(COLUMN_SIZE, next.load( ));
+
+  ministl::map(execution::par, column.begin( ), column.end( ), [](long long x) { return x + 1; });
+  std::atomic<long long> sum(0);
+  ministl::for_each(execution::par, column.begin( ), column.end( ),
+                    [&](long long x) { sum.fetch_add(x); });
+  EXPECT_EQ(ministl::accumulate(column.begin( ), column.end( ), 0ll), sum.load( ));
+
+  vector<long long> copied(COLUMN_SIZE);
+  EXPECT_EQ(copied.end( ), ministl::copy(execution::par, column.begin( ), column.end( ),
+                                          copied.begin( )));
+  EXPECT_TRUE(ministl::equal(column.begin( ), column.end( ), copied.begin( )));
+
+  // other iterators run sequentially
+  list<int> values;
+  for (int i = 0; i < 100; ++i)
+    values.push_back(i);
+  ministl::map(execution::par, values.begin( ), values.end( ), [](int x) { return 2 * x; });
+  EXPECT_EQ(9900, ministl::accumulate(execution::par, values.begin( ), values.end( ), 0));
+  ministl::fill(execution::seq, values.begin( ), values.end( ), 1);
+  EXPECT_EQ(100, ministl::accumulate(values.begin( ), values.end( ), 0));
+}
+
+TEST(ExecutionTest, find_count_test)
+{
+  vector<int> column(COLUMN_SIZE, 0);
+  const size_t positions[] = { 0, 5000, COLUMN_SIZE / 2, COLUMN_SIZE - 1 };
+  for (size_t i : positions)
+    column[i] = 1;
+  auto is_one = [](int x) { return x == 1; };
+
+  EXPECT_EQ(column.begin( ), ministl::find_if(execution::par, column.begin( ), column.end( ), is_one));
+  column[0] = 0;
+  EXPECT_EQ(column.begin( ) + 5000,
+            ministl::find_if(execution::par, column.begin( ), column.end( ), is_one));
+  EXPECT_EQ(column.end( ), ministl::find_if(execution::par, column.begin( ), column.end( ),
+                                            [](int x) { return x == 2; }));
+  EXPECT_EQ(3, ministl::count_if(execution::par, column.begin( ), column.end( ), is_one));
+  EXPECT_EQ(3, ministl::count_if(execution::seq, column.begin( ), column.end( ), is_one));
+
+  EXPECT_TRUE(ministl::any_of(execution::par, column.begin( ), column.end( ), is_one));
+  EXPECT_FALSE(ministl::none_of(execution::par, column.begin( ), column.end( ), is_one));
+  EXPECT_FALSE(ministl::all_of(execution::par, column.begin( ), column.end( ), is_one));
+  EXPECT_TRUE(ministl::all_of(execution::par_unseq, column.begin( ), column.end( ),
+                              [](int x) { return x < 2; }));
+}
+
+TEST(ExecutionTest, accumulate_inner_product_test)
+{
+  vector<double> a(COLUMN_SIZE), b(COLUMN_SIZE);
+  for (size_t i = 0; i < COLUMN_SIZE; ++i) {
+    a[i] = double(i % 100);
+    b[i] = 0.5;
+  }
+  const double sum = ministl::accumulate(a.begin( ), a.end( ), 1.0);
+  EXPECT_EQ(sum, ministl::accumulate(execution::par, a.begin( ), a.end( ), 1.0));
+  EXPECT_EQ(sum, ministl::accumulate(execution::par, a.begin( ), a.end( ), 1.0,
+                                     [](double x, double y) { return x + y; }));
+  EXPECT_EQ((sum - 1.0) / 2 + 1.0,
+            ministl::inner_product(execution::par, a.begin( ), a.end( ), b.begin( ), 1.0));
+
+  // the chunks are combined in order, an associative operation is enough
+  vector<std::string> words(20000, "ab");
+  words[0] = "x";
+  std::string joined = ministl::accumulate(execution::par, words.begin( ), words.end( ),
+                                           std::string("<"));
+  EXPECT_EQ(1 + 1 + 2 * 19999u, joined.size( ));
+  EXPECT_EQ("<xab", joined.substr(0, 4));
+}
+
+TEST(ExecutionTest, exception_test)
+{
+  vector<int> column(COLUMN_SIZE, 0);
+  column[COLUMN_SIZE / 3] = 1;
+  EXPECT_THROW(ministl::for_each(execution::par, column.begin( ), column.end( ), [](int x) {
+                 if (x == 1)
+                   throw std::runtime_error("bad value");
+               }), std::runtime_error);
+
+  // a parallel loop inside a parallel loop runs on the same pool
+  std::atomic<size_t> visited(0);
+  vector<int> outer(64 * PARALLEL_MIN_CHUNK, 0);
+  ministl::for_each(execution::par, outer.begin( ), outer.end( ), [&](int) {
+    if (visited.fetch_add(1) % PARALLEL_MIN_CHUNK == 0) {
+      EXPECT_EQ(0, ministl::count_if(execution::par, column.begin( ), column.end( ),
+                                     [](int x) { return x == 2; }));
+    }
+  });
+  EXPECT_EQ(outer.size( ), visited.load( ));
+}
+
+} // namespace ministl
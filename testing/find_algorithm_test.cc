@@ -4,6 +4,9 @@
 
 #include "gtest\gtest.h"
 #include "algorithm.h"
+#include "deque.h"
+#include "list.h"
+#include "vector.h"
 
 namespace ministl{
 
@@ -30,4 +33,129 @@ TEST_F(FindAlgorithmTest, find_test)
   }
 }
 
-} // namespace ministl
\ No newline at end of file
+TEST_F(FindAlgorithmTest, search_test)
+{
+  const int TEST_TIMES = 300;
+  // a small alphabet makes partial matches frequent
+  std::uniform_int_distribution<int> letter('a', 'c');
+  std::uniform_int_distribution<int> pattern_size(0, 20);
+
+  for (int i = 0; i < TEST_TIMES; ++i) {
+    std::vector<char> text(i * 3);
+    std::vector<char> pattern(pattern_size(random_engine));
+    for (auto& c : text)
+      c = char(letter(random_engine));
+    for (auto& c : pattern)
+      c = char(letter(random_engine));
+    if (!pattern.empty( ) && text.size( ) > pattern.size( ) && i % 2 == 0)
+      std::copy(pattern.begin( ), pattern.end( ), text.end( ) - pattern.size( ));
+    const size_t expected =
+      std::search(text.begin( ), text.end( ), pattern.begin( ), pattern.end( )) - text.begin( );
+
+    const char* t = text.data( );
+    const char* p = pattern.data( );
+    EXPECT_EQ(expected, size_t(ministl::search(t, t + text.size( ), p, p + pattern.size( )) - t));
+
+    vector<int> int_text(t, t + text.size( ));
+    vector<int> int_pattern(p, p + pattern.size( ));
+    EXPECT_EQ(expected, size_t(ministl::search(int_text.begin( ), int_text.end( ),
+                                               int_pattern.begin( ), int_pattern.end( )) -
+                               int_text.begin( )));
+
+    deque<char> deque_text;
+    list<char> list_text, list_pattern;
+    for (char c : text) {
+      deque_text.push_back(c);
+      list_text.push_back(c);
+    }
+    for (char c : pattern)
+      list_pattern.push_back(c);
+    EXPECT_EQ(expected, size_t(ministl::search(deque_text.begin( ), deque_text.end( ),
+                                               p, p + pattern.size( )) - deque_text.begin( )));
+
+    list<char>::iterator found = ministl::search(list_text.begin( ), list_text.end( ),
+                                                 list_pattern.begin( ), list_pattern.end( ));
+    EXPECT_EQ(expected, size_t(distance(list_text.begin( ), found)));
+
+    auto searcher = make_horspool_searcher(p, p + pattern.size( ));
+    EXPECT_EQ(expected, size_t(ministl::search(t, t + text.size( ), searcher) - t));
+    auto match = searcher(deque_text.begin( ), deque_text.end( ));
+    EXPECT_EQ(expected, size_t(match.first - deque_text.begin( )));
+    if (expected != text.size( )) {
+      EXPECT_EQ(pattern.size( ), size_t(match.second - match.first));
+    }
+  }
+
+  const unsigned char bytes[] = { 0, 255, 0, 255, 255, 1 };
+  const unsigned char needle[] = { 255, 255, 1 };
+  EXPECT_EQ(bytes + 3, search(bytes, bytes + 6, needle, needle + 3));
+  EXPECT_EQ(bytes + 6, search(bytes, bytes + 6, needle, needle + 3) + 3);
+  EXPECT_EQ(bytes, search(bytes, bytes + 6, needle, needle));
+  EXPECT_EQ(bytes + 2, search(bytes, bytes + 2, needle, needle + 3));
+
+  // values of different types are compared as values, not as bytes
+  const char signed_text[] = { 'a', char(0xff), 'b' };
+  const unsigned char unsigned_pattern[] = { 0xff, 'b' };
+  EXPECT_EQ(signed_text + 3, search(signed_text, signed_text + 3,
+                                    unsigned_pattern, unsigned_pattern + 2));
+  std::vector<unsigned char> long_pattern(HORSPOOL_MIN_PATTERN, 0xff);
+  std::vector<char> long_text(3 * HORSPOOL_MIN_PATTERN, char(0xff));
+  EXPECT_EQ(long_text.data( ) + long_text.size( ),
+            search(long_text.data( ), long_text.data( ) + long_text.size( ),
+                   long_pattern.data( ), long_pattern.data( ) + long_pattern.size( )));
+}
+
+TEST_F(FindAlgorithmTest, find_first_of_test)
+{
+  const int TEST_TIMES = 200;
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::uniform_int_distribution<int> key_count(0, 40);
+
+  for (int i = 0; i < TEST_TIMES; ++i) {
+    std::vector<unsigned char> keys(key_count(random_engine));
+    for (auto& c : keys)
+      c = (unsigned char)byte(random_engine);
+    // the text holds no key but, sometimes, the planted one
+    std::vector<unsigned char> text(i * 7);
+    for (auto& c : text) {
+      do
+        c = (unsigned char)byte(random_engine);
+      while (std::find(keys.begin( ), keys.end( ), c) != keys.end( ));
+    }
+    if (!keys.empty( ) && !text.empty( ) && i % 2 == 0)
+      text[byte(random_engine) * text.size( ) / 256] = keys[i % keys.size( )];
+    const size_t expected = std::find_first_of(text.begin( ), text.end( ), keys.begin( ), keys.end( )) -
+                            text.begin( );
+
+    const unsigned char* t = text.data( );
+    const unsigned char* k = keys.data( );
+    EXPECT_EQ(expected, size_t(ministl::find_first_of(t, t + text.size( ), k, k + keys.size( )) - t));
+
+    deque<unsigned char> deque_text;
+    for (unsigned char c : text)
+      deque_text.push_back(c);
+    EXPECT_EQ(expected, size_t(ministl::find_first_of(deque_text.begin( ), deque_text.end( ),
+                                                      k, k + keys.size( )) - deque_text.begin( )));
+
+    vector<long long> wide_text(t, t + text.size( ));
+    vector<long long> wide_keys(k, k + keys.size( ));
+    EXPECT_EQ(expected, size_t(ministl::find_first_of(wide_text.begin( ), wide_text.end( ),
+                                                      wide_keys.begin( ), wide_keys.end( )) -
+                               wide_text.begin( )));
+    EXPECT_EQ(expected, size_t(ministl::find_first_of(wide_text.begin( ), wide_text.end( ),
+                                                      k, k + keys.size( ),
+                                                      [](long long x, unsigned char y) {
+                                                        return x == y;
+                                                      }) - wide_text.begin( )));
+  }
+
+  // the bytes are compared as values of the same type
+  const char text[] = "key=value;next";
+  const char delimiters[] = ";=";
+  EXPECT_EQ(text + 3, ministl::find_first_of(text, text + 14, delimiters, delimiters + 2));
+  const signed char negative[] = { 1, 2, -1, 3 };
+  const signed char minus_one[] = { -1 };
+  EXPECT_EQ(negative + 2, ministl::find_first_of(negative, negative + 4, minus_one, minus_one + 1));
+}
+
+} // namespace ministl
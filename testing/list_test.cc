@@ -0,0 +1,40 @@
+#include "list.h"
+#include "arena_alloc.h"
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+TEST(ListTest, stateful_allocator_test)
+{
+  EXPECT_EQ(sizeof(void*), sizeof(ministl::list<int>));
+
+  monotonic_arena arena;
+  ministl::list<int, arena_ref> int_list((arena_ref(arena)));
+  EXPECT_TRUE(int_list.get_allocator( ) == arena_ref(arena));
+  const size_t header_size = arena.size( );
+  EXPECT_GT(header_size, 0u);
+
+  for (int i = 0; i < 100; ++i) {
+    int_list.push_back(i);
+    int_list.push_front(-i);
+  }
+  EXPECT_EQ(200u, int_list.size( ));
+  EXPECT_EQ(-99, int_list.front( ));
+  EXPECT_EQ(99, int_list.back( ));
+  EXPECT_GE(arena.size( ), header_size + 200 * sizeof(int));
+
+  int_list.pop_front( );
+  int_list.pop_back( );
+  int_list.remove(0);
+  EXPECT_EQ(196u, int_list.size( ));
+  int sum = 0;
+  for (ministl::list<int, arena_ref>::iterator it = int_list.begin( ); it != int_list.end( ); ++it)
+    sum += *it;
+  EXPECT_EQ(0, sum);
+
+  int_list.clear( );
+  EXPECT_EQ(0u, int_list.size( ));
+  EXPECT_TRUE(int_list.begin( ) == int_list.end( ));
+}
+
+} // namespace ministl
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include "numa_alloc.h"
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+TEST(NumaAllocTemplateTest, simulated_nodes_test)
+{
+  typedef numa_alloc_template<1, 4> numa;
+  numa::set_simulated_nodes(2);
+  EXPECT_EQ(2, numa::node_count( ));
+  numa::set_simulated_nodes(0);
+  EXPECT_GE(numa::node_count( ), 1);
+
+  numa::bind_thread_to_node(3);
+  EXPECT_EQ(3, numa::node_of_current_thread( ));
+  numa::bind_thread_to_node(-1);
+  EXPECT_LT(numa::node_of_current_thread( ), 4);
+}
+
+TEST(NumaAllocTemplateTest, remote_deallocate_test)
+{
+  typedef numa_alloc_template<2, 2> numa;
+  const int test_times = 1000;
+  const size_t large = 1000;
+  std::vector<void*> blocks(test_times);
+  void* large_block = 0;
+
+  std::thread producer([&blocks, &large_block]( ) {
+    numa::bind_thread_to_node(0);
+    for (auto& p : blocks)
+      p = numa::allocate(32);
+    large_block = numa::allocate(large);
+  });
+  producer.join( );
+
+  numa_node_stats stats;
+  numa::get_node_stats(0, stats);
+  EXPECT_GT(stats.pool.heap_size, 0u);
+  const size_t heap_size = stats.pool.heap_size;
+  numa::get_node_stats(1, stats);
+  EXPECT_EQ(0u, stats.pool.heap_size);
+
+  // the objects go back to the pool of node 0 although node 1 frees them
+  std::thread consumer([&blocks, large_block]( ) {
+    numa::bind_thread_to_node(1);
+    for (auto p : blocks)
+      numa::deallocate(p, 32);
+    numa::deallocate(large_block, large);
+  });
+  consumer.join( );
+
+  numa::get_node_stats(1, stats);
+  EXPECT_EQ(0u, stats.pool.heap_size);
+  numa::get_node_stats(0, stats);
+  EXPECT_EQ(heap_size, stats.pool.heap_size);
+#ifdef MINISTL_ALLOC_STATS
+  EXPECT_EQ(size_t(test_times), stats.allocations);
+  EXPECT_EQ(size_t(test_times), stats.deallocations);
+  EXPECT_EQ(size_t(test_times), stats.remote_deallocations);
+#endif
+
+  EXPECT_GT(numa::release_unused( ), 0u);
+  numa::get_node_stats(0, stats);
+  EXPECT_EQ(0u, stats.pool.heap_size);
+}
+
+// objects of both nodes spread over many chunks, freed in random order by a
+// thread of a third node
+TEST(NumaAllocTemplateTest, shuffled_deallocate_test)
+{
+  typedef numa_alloc_template<3, 4> numa;
+  const int test_times = 100000;
+  std::vector<void*> blocks(test_times);
+  std::vector<int> owners(test_times);
+
+  for (int i = 0; i < test_times; ++i) {
+    owners[i] = i % 3 == 0 ? 1 : 0;
+    numa::bind_thread_to_node(owners[i]);
+    blocks[i] = numa::allocate(8 + i % 120);
+    memset(blocks[i], owners[i], 8);
+  }
+  numa_node_stats stats;
+  size_t heap_size[2];
+  for (int node = 0; node < 2; ++node) {
+    numa::get_node_stats(node, stats);
+    heap_size[node] = stats.pool.heap_size;
+    EXPECT_GT(heap_size[node], size_t(NUMA_REGION_SIZE));
+  }
+
+  std::vector<int> order(test_times);
+  for (int i = 0; i < test_times; ++i)
+    order[i] = i;
+  std::shuffle(order.begin( ), order.end( ), std::mt19937(42));
+  numa::bind_thread_to_node(2);
+  for (int i : order)
+    numa::deallocate(blocks[i], 8 + i % 120);
+
+  for (int node = 0; node < 2; ++node) {
+    numa::get_node_stats(node, stats);
+    EXPECT_EQ(heap_size[node], stats.pool.heap_size);
+#ifdef MINISTL_ALLOC_STATS
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+    EXPECT_EQ(stats.allocations, stats.remote_deallocations);
+#endif
+  }
+  numa::get_node_stats(2, stats);
+  EXPECT_EQ(0u, stats.pool.heap_size);
+
+  // every chunk is whole again only if each object went back to its pool
+  numa::release_unused( );
+  for (int node = 0; node < 2; ++node) {
+    numa::get_node_stats(node, stats);
+    EXPECT_EQ(0u, stats.pool.heap_size);
+  }
+  numa::bind_thread_to_node(-1);
+}
+
+} // namespace ministl
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "algorithm.h"
+#include "simd.h"
+#include "vector.h"
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+struct pixel {
+  uint32_t r, g, b, a;
+  bool operator==(const pixel& rhs) const
+  {
+    return r == rhs.r && g == rhs.g && b == rhs.b && a == rhs.a;
+  }
+};
+
+struct rgb {
+  unsigned char r, g, b;
+  bool operator==(const rgb& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+};
+
+// fill every length and offset of a guarded buffer and check nothing else
+// is touched. The offsets cover every alignment of the 32 byte stores.
+template <typename T>
+void check_fill(const T& value, const T& guard)
+{
+  for (size_t offset = 0; offset < 32; ++offset) {
+    for (size_t n = 0; n < 300; n += (n < 70 ? 1 : 37)) {
+      std::vector<T> buffer(offset + n + 8, guard);
+      T* first = &buffer[0] + offset;
+      if (n % 2 == 0)
+        fill(first, first + n, value);
+      else
+        EXPECT_EQ(first + n, fill_n(first, n, value));
+      for (size_t i = 0; i < buffer.size( ); ++i) {
+        const bool filled = i >= offset && i < offset + n;
+        EXPECT_TRUE(buffer[i] == (filled ? value : guard));
+      }
+    }
+  }
+}
+
+TEST(SimdTest, cpu_features_test)
+{
+  EXPECT_EQ(simd::cpu_features( ), simd::detect_cpu_features( ));
+  if (simd::has_avx2( )) {
+    EXPECT_TRUE(simd::has_sse2( ));
+  }
+}
+
+TEST(SimdTest, fill_test)
+{
+  check_fill<unsigned char>(0xab, 0);
+  check_fill<uint16_t>(0x1234, 0);
+  check_fill<int>(-5, 7);
+  check_fill<float>(1.5f, 0.0f);
+  check_fill<double>(-2.25, 1.0);
+  check_fill<uint64_t>(0x0102030405060708ull, 0);
+  pixel p = { 1, 2, 3, 4 }, q = { 0, 0, 0, 0 };
+  check_fill(p, q);
+  rgb c = { 1, 2, 3 }, d = { 0, 0, 0 };
+  check_fill(c, d);
+
+  ministl::vector<double> vec(1000, 3.5);
+  EXPECT_EQ(3.5, vec[999]);
+  vec.resize(5000, 4.5);
+  EXPECT_EQ(3.5, vec[999]);
+  EXPECT_EQ(4.5, vec[4999]);
+}
+
+// compare find and count with the std algorithms on every length and on
+// matches at every position near the block boundaries
+template <typename T>
+void check_find_count(T value, T other)
+{
+  std::default_random_engine engine;
+  for (size_t n = 0; n < 200; ++n) {
+    std::vector<T> seq(n + 1, other);
+    const T* first = &seq[0];
+    const T* last = first + n;
+    EXPECT_EQ(last, find(first, last, value));
+    EXPECT_EQ(0, count(first, last, value));
+    for (int round = 0; round < 3 && n > 0; ++round) {
+      seq[engine( ) % n] = value;
+      EXPECT_EQ(std::find(first, last, value), find(first, last, value));
+      EXPECT_EQ(std::count(first, last, value), count(first, last, value));
+    }
+  }
+  std::vector<T> column(1 << 20, other);
+  column[column.size( ) - 3] = value;
+  T* data = &column[0];
+  EXPECT_EQ(data + column.size( ) - 3, find(data, data + column.size( ), value));
+  EXPECT_EQ(1, count(data, data + column.size( ), value));
+  EXPECT_EQ(ptrdiff_t(column.size( ) - 1), count(data, data + column.size( ), other));
+}
+
+TEST(SimdTest, find_count_test)
+{
+  check_find_count<char>('x', 'y');
+  check_find_count<int8_t>(-1, 1);
+  check_find_count<uint16_t>(0xffff, 0xfffe);
+  check_find_count<int>(-7, 7);
+  check_find_count<uint32_t>(0x80000000u, 0);
+  check_find_count<int64_t>(0x100000000ll, 0);
+  check_find_count<uint64_t>(1, 0x100000001ull);
+  check_find_count<float>(2.5f, -2.5f);
+  check_find_count<double>(1e300, -1e300);
+
+  // floating point equality is not bitwise equality
+  std::vector<double> values(100, 1.0);
+  values[50] = -0.0;
+  values[60] = NAN;
+  EXPECT_EQ(&values[50], find(&values[0], &values[0] + 100, 0.0));
+  EXPECT_EQ(&values[0] + 100, find(&values[0], &values[0] + 100, double(NAN)));
+  EXPECT_EQ(0, count(&values[0], &values[0] + 100, double(NAN)));
+}
+
+} // namespace ministl
@@ -0,0 +1,164 @@
+#include "small_vector.h"
+#include "arena_alloc.h"
+#include "vector.h"
+#include <algorithm>
+#include <string>
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+TEST(SmallVectorTest, inline_spill_test)
+{
+  ministl::small_vector<int, 8> vec;
+  EXPECT_EQ(8, vec.capacity( ));
+  EXPECT_TRUE(vec.is_inline( ));
+  for (int i = 0; i < 8; ++i)
+    vec.push_back(i);
+  EXPECT_TRUE(vec.is_inline( ));
+  EXPECT_EQ(8, vec.size( ));
+
+  vec.push_back(8);
+  EXPECT_FALSE(vec.is_inline( ));
+  EXPECT_EQ(16, vec.capacity( ));
+  for (int i = 9; i < 100; ++i)
+    vec.push_back(i);
+  EXPECT_EQ(100, vec.size( ));
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, vec[i]);
+
+  vec.erase(vec.begin( ), vec.begin( ) + 50);
+  EXPECT_EQ(50, vec.front( ));
+  vec.pop_back( );
+  EXPECT_EQ(98, vec.back( ));
+  vec.clear( );
+  EXPECT_TRUE(vec.empty( ));
+}
+
+TEST(SmallVectorTest, insert_emplace_test)
+{
+  ministl::small_vector<std::string, 4> strs;
+  strs.emplace_back(3, 'a');
+  strs.push_back("c");
+  strs.insert(strs.begin( ) + 1, "b");
+  EXPECT_TRUE(strs.is_inline( ));
+  strs.insert(strs.begin( ), 2, "x");
+  EXPECT_FALSE(strs.is_inline( ));
+  const std::string expected[] = { "x", "x", "aaa", "b", "c" };
+  EXPECT_EQ(5, strs.size( ));
+  EXPECT_TRUE(std::equal(expected, expected + 5, strs.begin( )));
+
+  // an element of the vector itself while spilling
+  ministl::small_vector<std::string, 2> self(2, "test");
+  self.push_back(self[0]);
+  self.emplace(self.begin( ), self.back( ));
+  EXPECT_EQ(4, self.size( ));
+  EXPECT_TRUE(std::all_of(self.begin( ), self.end( ), [](const std::string& str) { return str == "test"; }));
+
+  ministl::small_vector<int, 4> ints;
+  const int values[] = { 1, 2, 3, 4, 5, 6 };
+  ints.insert(ints.end( ), values, values + 3);
+  ints.insert(ints.begin( ) + 1, values + 3, values + 6);
+  const int inserted[] = { 1, 4, 5, 6, 2, 3 };
+  EXPECT_TRUE(std::equal(inserted, inserted + 6, ints.begin( )));
+  ints.resize(2);
+  EXPECT_EQ(2, ints.size( ));
+  ints.resize(3, 7);
+  EXPECT_EQ(7, ints.back( ));
+}
+
+TEST(SmallVectorTest, copy_move_test)
+{
+  ministl::small_vector<std::string, 4> small(3, "small");
+  ministl::small_vector<std::string, 4> large(10, "large");
+
+  ministl::small_vector<std::string, 4> copy(small);
+  EXPECT_TRUE(copy.is_inline( ));
+  EXPECT_EQ(3, copy.size( ));
+  copy = large;
+  EXPECT_EQ(10, copy.size( ));
+  EXPECT_EQ("large", copy[9]);
+
+  ministl::small_vector<std::string, 4> moved(std::move(small));
+  EXPECT_TRUE(moved.is_inline( ));
+  EXPECT_EQ(3, moved.size( ));
+  EXPECT_TRUE(small.empty( ));
+
+  const std::string* data = large.begin( );
+  moved = std::move(large);
+  EXPECT_EQ(data, moved.begin( ));
+  EXPECT_EQ(10, moved.size( ));
+  EXPECT_TRUE(large.empty( ));
+  EXPECT_TRUE(large.is_inline( ));
+
+  ministl::vector<ministl::small_vector<int, 2> > nested;
+  for (int i = 0; i < 20; ++i)
+    nested.emplace_back(size_t(i), i);
+  EXPECT_EQ(19, nested[19].size( ));
+  EXPECT_EQ(19, nested[19].back( ));
+}
+
+TEST(SmallVectorTest, swap_assign_shrink_test)
+{
+  ministl::small_vector<std::string, 4> small(2, "small");
+  ministl::small_vector<std::string, 4> large(10, "large");
+  small.swap(large);
+  EXPECT_EQ(10, small.size( ));
+  EXPECT_FALSE(small.is_inline( ));
+  EXPECT_EQ(2, large.size( ));
+  EXPECT_TRUE(large.is_inline( ));
+  EXPECT_EQ("large", small[9]);
+  EXPECT_EQ("small", large[1]);
+
+  ministl::small_vector<std::string, 4> other(20, "other");
+  small.swap(other);
+  EXPECT_EQ(20, small.size( ));
+  EXPECT_EQ("large", other[0]);
+
+  const int values[] = { 1, 2, 3, 4, 5, 6 };
+  ministl::small_vector<int, 4> ints(values, values + 6);
+  ints.assign(values + 1, values + 3);
+  EXPECT_EQ(2, ints.size( ));
+  EXPECT_EQ(3, ints.back( ));
+  ints.assign(3, ints[0]);
+  EXPECT_EQ(3, ints.size( ));
+  EXPECT_EQ(2, ints.back( ));
+
+  // the elements fit in the buffer again
+  ints.shrink_to_fit( );
+  EXPECT_TRUE(ints.is_inline( ));
+  EXPECT_EQ(4, ints.capacity( ));
+  EXPECT_EQ(2, ints[2]);
+  ints.assign(values, values + 6);
+  ints.reserve(32);
+  ints.shrink_to_fit( );
+  EXPECT_EQ(6, ints.capacity( ));
+  EXPECT_TRUE(std::equal(values, values + 6, ints.begin( )));
+}
+
+TEST(SmallVectorTest, stateful_allocator_test)
+{
+  monotonic_arena first_arena, second_arena;
+  ministl::small_vector<int, 2, arena_ref> first((arena_ref(first_arena)));
+  ministl::small_vector<int, 2, arena_ref> second((arena_ref(second_arena)));
+  for (int i = 0; i < 10; ++i)
+    first.push_back(i);
+
+  // the storage keeps the allocator it came from
+  second = std::move(first);
+  EXPECT_TRUE(second.get_allocator( ) == arena_ref(first_arena));
+  const size_t used = second_arena.size( );
+  second.push_back(10);
+  second.shrink_to_fit( );
+  EXPECT_EQ(used, second_arena.size( ));
+  EXPECT_EQ(10, second.back( ));
+
+  ministl::small_vector<int, 2, arena_ref> third((arena_ref(second_arena)));
+  third.push_back(-1);
+  third.swap(second);
+  EXPECT_TRUE(third.get_allocator( ) == arena_ref(first_arena));
+  EXPECT_TRUE(second.get_allocator( ) == arena_ref(second_arena));
+  EXPECT_EQ(11, third.size( ));
+  EXPECT_EQ(-1, second[0]);
+}
+
+} // namespace ministl
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "deque.h"
+#include "sort.h"
+#include "vector.h"
+
+namespace ministl {
+
+// the inputs every sort is checked on: random values with many or few
+// duplicates, sorted, reversed and organ pipe sequences
+std::vector<std::vector<int>> sort_inputs( )
+{
+  std::default_random_engine e;
+  std::vector<std::vector<int>> inputs;
+  const int sizes[] = { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 10000 };
+  for (int n : sizes) {
+    std::uniform_int_distribution<int> wide(-1000000, 1000000), narrow(0, 5);
+    std::vector<int> random(n), duplicates(n), sorted(n), reversed(n), pipe(n);
+    for (int i = 0; i < n; ++i) {
+      random[i] = wide(e);
+      duplicates[i] = narrow(e);
+      sorted[i] = i;
+      reversed[i] = n - i;
+      pipe[i] = i < n / 2 ? i : n - i;
+    }
+    inputs.push_back(random);
+    inputs.push_back(duplicates);
+    inputs.push_back(sorted);
+    inputs.push_back(reversed);
+    inputs.push_back(pipe);
+  }
+  return inputs;
+}
+
+TEST(SortTest, sort_test)
+{
+  for (const auto& input : sort_inputs( )) {
+    std::vector<int> expected = input;
+    std::sort(expected.begin( ), expected.end( ));
+
+    vector<int> v(input.data( ), input.data( ) + input.size( ));
+    ministl::sort(v.begin( ), v.end( ));
+    EXPECT_TRUE(std::equal(expected.begin( ), expected.end( ), v.begin( )));
+
+    deque<int> d;
+    for (int x : input)
+      d.push_back(x);
+    ministl::sort(d.begin( ), d.end( ), [](int a, int b) { return b < a; });
+    EXPECT_TRUE(std::equal(expected.rbegin( ), expected.rend( ), d.begin( )));
+  }
+
+  std::vector<std::string> words = { "pear", "apple", "fig", "banana", "kiwi", "cherry", "date",
+                                     "lime", "grape", "melon", "plum", "peach", "mango", "lemon",
+                                     "olive", "quince", "papaya", "guava", "apricot", "orange" };
+  std::vector<std::string> expected = words;
+  std::sort(expected.begin( ), expected.end( ));
+  ministl::sort(words.data( ), words.data( ) + words.size( ));
+  EXPECT_EQ(expected, words);
+}
+
+TEST(SortTest, stable_sort_test)
+{
+  for (const auto& input : sort_inputs( )) {
+    // the keys have many duplicates, the second member records the order
+    std::vector<std::pair<int, int>> expected;
+    for (size_t i = 0; i < input.size( ); ++i)
+      expected.push_back(std::make_pair(input[i] % 7, int(i)));
+    vector<std::pair<int, int>> v(expected.data( ), expected.data( ) + expected.size( ));
+    auto by_key = [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+      return a.first < b.first;
+    };
+    std::stable_sort(expected.begin( ), expected.end( ), by_key);
+    ministl::stable_sort(v.begin( ), v.end( ), by_key);
+    EXPECT_TRUE(std::equal(expected.begin( ), expected.end( ), v.begin( )));
+
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin( ), sorted.end( ));
+    deque<int> d;
+    for (int x : input)
+      d.push_back(x);
+    ministl::stable_sort(d.begin( ), d.end( ));
+    EXPECT_TRUE(std::equal(sorted.begin( ), sorted.end( ), d.begin( )));
+  }
+
+  std::vector<std::string> words(100);
+  for (size_t i = 0; i < words.size( ); ++i)
+    words[i] = std::string(1, char('a' + i % 5)) + std::to_string(i);
+  std::vector<std::string> expected = words;
+  auto by_first = [](const std::string& a, const std::string& b) { return a[0] < b[0]; };
+  std::stable_sort(expected.begin( ), expected.end( ), by_first);
+  ministl::stable_sort(words.data( ), words.data( ) + words.size( ), by_first);
+  EXPECT_EQ(expected, words);
+}
+
+TEST(SortTest, partial_sort_test)
+{
+  for (const auto& input : sort_inputs( )) {
+    std::vector<int> expected = input;
+    std::sort(expected.begin( ), expected.end( ));
+    const size_t k = input.size( ) / 3;
+
+    vector<int> v(input.data( ), input.data( ) + input.size( ));
+    ministl::partial_sort(v.begin( ), v.begin( ) + k, v.end( ));
+    EXPECT_TRUE(std::equal(expected.begin( ), expected.begin( ) + k, v.begin( )));
+
+    deque<int> d;
+    for (int x : input)
+      d.push_back(x);
+    ministl::partial_sort(d.begin( ), d.begin( ) + k, d.end( ), [](int a, int b) { return b < a; });
+    EXPECT_TRUE(std::equal(expected.rbegin( ), expected.rbegin( ) + k, d.begin( )));
+  }
+}
+
+TEST(SortTest, nth_element_test)
+{
+  for (const auto& input : sort_inputs( )) {
+    if (input.empty( ))
+      continue;
+    std::vector<int> expected = input;
+    std::sort(expected.begin( ), expected.end( ));
+
+    for (size_t n : { size_t(0), input.size( ) / 2, input.size( ) - 1 }) {
+      vector<int> v(input.data( ), input.data( ) + input.size( ));
+      ministl::nth_element(v.begin( ), v.begin( ) + n, v.end( ));
+      EXPECT_EQ(expected[n], v[n]);
+      for (size_t i = 0; i < n; ++i)
+        EXPECT_LE(v[i], v[n]);
+      for (size_t i = n; i < v.size( ); ++i)
+        EXPECT_GE(v[i], v[n]);
+
+      deque<int> d;
+      for (int x : input)
+        d.push_back(x);
+      ministl::nth_element(d.begin( ), d.begin( ) + n, d.end( ), std::greater<int>( ));
+      EXPECT_EQ(expected[input.size( ) - 1 - n], d[n]);
+    }
+  }
+}
+
+template <typename T>
+void check_radix_sort(T low, T high)
+{
+  std::default_random_engine e;
+  for (size_t n : { 0, 1, 63, 64, 1000, 100000 }) {
+    std::vector<T> expected(n);
+    for (size_t i = 0; i < n; ++i)
+      expected[i] = T(low + (high - low) * (double(e( )) / e.max( )));
+    vector<T> v(expected.data( ), expected.data( ) + n);
+    std::sort(expected.begin( ), expected.end( ));
+    radix_sort(v.begin( ), v.end( ));
+    EXPECT_TRUE(std::equal(expected.begin( ), expected.end( ), v.begin( )));
+  }
+}
+
+TEST(SortTest, radix_sort_test)
+{
+  check_radix_sort<unsigned char>(0, 255);
+  check_radix_sort<short>(-30000, 30000);
+  check_radix_sort<int>(-1000000000, 1000000000);
+  check_radix_sort<unsigned>(0, 4000000000u);
+  // the high bytes are all equal, their passes are skipped
+  check_radix_sort<unsigned long long>(0, 1000);
+  // one pass runs, the elements come back from the buffer
+  check_radix_sort<unsigned long long>(0, 200);
+  check_radix_sort<int>(7, 7);
+  check_radix_sort<long long>(-1e18, 1e18);
+  check_radix_sort<float>(-1e30f, 1e30f);
+  check_radix_sort<double>(-1.0, 1.0);
+
+  std::vector<double> specials = { 3.0, -0.0, INFINITY, -1.5, 0.0, -INFINITY, 1e-300, -1e-300 };
+  for (int i = 0; i < 100; ++i)
+    specials.push_back(specials[i % 8] * i);
+  std::vector<double> expected = specials;
+  std::sort(expected.begin( ), expected.end( ));
+  radix_sort(specials.data( ), specials.data( ) + specials.size( ));
+  EXPECT_TRUE(std::equal(expected.begin( ), expected.end( ), specials.begin( )));
+  EXPECT_TRUE(std::signbit(specials[std::lower_bound(specials.begin( ), specials.end( ), 0.0) -
+                                    specials.begin( )]));
+}
+
+TEST(SortTest, radix_sort_key_test)
+{
+  std::default_random_engine e;
+  std::uniform_int_distribution<long long> time(-50, 50);
+  // records of a timestamp and a name
+  typedef std::pair<long long, std::string> record;
+  std::vector<record> expected(5000);
+  for (size_t i = 0; i < expected.size( ); ++i)
+    expected[i] = record(time(e) * 1000000007ll, std::to_string(i));
+  std::vector<record> records = expected;
+  auto by_time = [](const record& a, const record& b) { return a.first < b.first; };
+  std::stable_sort(expected.begin( ), expected.end( ), by_time);
+  radix_sort<malloc_alloc>(records.data( ), records.data( ) + records.size( ),
+                           [](const record& x) { return x.first; });
+  EXPECT_EQ(expected, records);
+}
+
+// counts its live instances, its move constructor throws on demand
+struct radix_counted {
+  static int live;
+  static int moves_left;
+  int key;
+
+  explicit radix_counted(int k) : key(k) { ++live; }
+  radix_counted(const radix_counted& x) : key(x.key) { ++live; }
+  radix_counted(radix_counted&& x) : key(x.key)
+  {
+    if (moves_left-- == 0)
+      throw std::runtime_error("move");
+    ++live;
+  }
+  radix_counted& operator=(radix_counted&& x)
+  {
+    key = x.key;
+    return *this;
+  }
+  ~radix_counted( ) { --live; }
+};
+
+int radix_counted::live = 0;
+int radix_counted::moves_left = -1;
+
+TEST(SortTest, radix_sort_exception_test)
+{
+  auto by_key = [](const radix_counted& x) { return x.key; };
+  std::vector<radix_counted> values;
+  for (int i = 0; i < 1000; ++i)
+    values.push_back(radix_counted((i * 7919) % 1000));
+  const int live = radix_counted::live;
+
+  // the buffer is built by the first pass, which throws half way
+  radix_counted::moves_left = 500;
+  EXPECT_THROW(radix_sort(values.data( ), values.data( ) + values.size( ), by_key),
+               std::runtime_error);
+  EXPECT_EQ(live, radix_counted::live);
+
+  for (size_t i = 0; i < values.size( ); ++i)
+    values[i].key = int(values.size( ) - i);
+  radix_counted::moves_left = -1;
+  radix_sort(values.data( ), values.data( ) + values.size( ), by_key);
+  EXPECT_EQ(live, radix_counted::live);
+  for (size_t i = 0; i < values.size( ); ++i)
+    EXPECT_EQ(int(i + 1), values[i].key);
+}
+
+} // namespace ministl
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace ministl {
+
+TEST(ThreadPoolTest, work_stealing_deque_test)
+{
+  work_stealing_deque<size_t> tasks(2);
+  size_t x = 0;
+  EXPECT_TRUE(tasks.empty( ));
+  EXPECT_FALSE(tasks.pop(x));
+  EXPECT_FALSE(tasks.steal(x));
+
+  // the ring grows past its first capacity
+  for (size_t i = 1; i <= 10; ++i)
+    tasks.push(i);
+  EXPECT_TRUE(tasks.steal(x));
+  EXPECT_EQ(1u, x);
+  EXPECT_TRUE(tasks.pop(x));
+  EXPECT_EQ(10u, x);
+
+  // a capacity which is not a power of two does not alias slots
+  work_stealing_deque<size_t> odd(100);
+  for (size_t i = 0; i < 300; ++i)
+    odd.push(i);
+  for (size_t i = 0; i < 300; ++i) {
+    EXPECT_TRUE(odd.steal(x));
+    EXPECT_EQ(i, x);
+  }
+
+  // the owner pops while thieves steal, every element is taken once
+  const size_t count = 100000;
+  std::vector<std::atomic<int>> taken(count + 1);
+  std::atomic<bool> done(false);
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.push_back(std::thread([&]( ) {
+      size_t y;
+      while (!done.load( ) || !tasks.empty( )) {
+        if (tasks.steal(y))
+          taken[y].fetch_add(1);
+      }
+    }));
+  }
+  for (size_t i = 11; i <= count; ++i) {
+    tasks.push(i);
+    if (i % 3 == 0 && tasks.pop(x))
+      taken[x].fetch_add(1);
+  }
+  while (tasks.pop(x))
+    taken[x].fetch_add(1);
+  done.store(true);
+  for (auto& t : thieves)
+    t.join( );
+  for (size_t i = 2; i <= count; ++i) {
+    if (i != 10) {
+      EXPECT_EQ(1, taken[i].load( ));
+    }
+  }
+}
+
+TEST(ThreadPoolTest, fork_join_test)
+{
+  thread_pool pool(3);
+  EXPECT_EQ(4u, pool.concurrency( ));
+
+  // naive fibonacci, every call forks one half and computes the other
+  std::function<long(int)> fib = [&](int n) -> long {
+    if (n < 2)
+      return n;
+    long a = 0;
+    auto left = pool.fork([&]( ) { a = fib(n - 1); });
+    long b = fib(n - 2);
+    left.join( );
+    return a + b;
+  };
+  EXPECT_EQ(6765, fib(20));
+
+  auto failing = pool.fork([]( ) { throw std::runtime_error("bad task"); });
+  EXPECT_THROW(failing.join( ), std::runtime_error);
+  EXPECT_FALSE(failing.joinable( ));
+
+  // a handle which is not joined waits in its destructor
+  std::atomic<int> runs(0);
+  {
+    auto h = pool.fork([&]( ) { runs.fetch_add(1); });
+  }
+  EXPECT_EQ(1, runs.load( ));
+}
+
+TEST(ThreadPoolTest, parallel_for_test)
+{
+  thread_pool pool(4);
+  vector<int> column(100000, 1);
+  pool.parallel_for(column.begin( ), column.end( ), [](vector<int>::iterator first,
+                                                       vector<int>::iterator last) {
+    for (; first != last; ++first)
+      *first *= 2;
+  });
+  for (int x : column)
+    EXPECT_EQ(2, x);
+
+  std::atomic<size_t> blocks(0), total(0);
+  pool.parallel_for(column.begin( ), column.end( ), [&](vector<int>::iterator first,
+                                                        vector<int>::iterator last) {
+    EXPECT_LE(last - first, 1000);
+    blocks.fetch_add(1);
+    total.fetch_add(last - first);
+  }, 1000);
+  EXPECT_LE(128u, blocks.load( ));
+  EXPECT_EQ(column.size( ), total.load( ));
+
+  // on the default pool
+  std::vector<std::atomic<int>> runs(1000);
+  parallel_for(size_t(0), runs.size( ), [&](size_t first, size_t last) {
+    for (; first != last; ++first)
+      runs[first].fetch_add(1);
+  });
+  for (auto& r : runs)
+    EXPECT_EQ(1, r.load( ));
+}
+
+TEST(ThreadPoolTest, parallel_chunks_test)
+{
+  thread_pool pool(4);
+  EXPECT_EQ(5u, pool.concurrency( ));
+
+  const size_t chunks = 1000;
+  std::vector<std::atomic<int>> runs(chunks);
+  pool.parallel_chunks(chunks, [&](size_t c) { runs[c].fetch_add(1); });
+  for (auto& r : runs)
+    EXPECT_EQ(1, r.load( ));
+
+  std::atomic<size_t> inner(0);
+  pool.parallel_chunks(16, [&](size_t) {
+    pool.parallel_chunks(16, [&](size_t) { inner.fetch_add(1); });
+  });
+  EXPECT_EQ(256u, inner.load( ));
+
+  EXPECT_THROW(pool.parallel_chunks(chunks, [](size_t c) {
+                 if (c == 500)
+                   throw std::runtime_error("bad chunk");
+               }), std::runtime_error);
+  pool.parallel_chunks(0, [](size_t) { FAIL( ); });
+}
+
+} // namespace ministl
@@ -0,0 +1,40 @@
+#include <string>
+
+#include "type_traits.h"
+#include "gtest/gtest.h"
+
+namespace ministl {
+
+struct plain_point {
+  int x;
+  int y;
+};
+
+struct with_destructor {
+  ~with_destructor( ) { }
+};
+
+template <typename T>
+bool is_true(T) { return false; }
+
+template <>
+bool is_true(true_type) { return true; }
+
+TEST(TypeTraitsTest, derived_traits_test)
+{
+  EXPECT_TRUE(is_true(type_traits<int>::is_POD_type( )));
+  EXPECT_TRUE(is_true(type_traits<const char*>::is_POD_type( )));
+  EXPECT_TRUE(is_true(type_traits<plain_point>::is_POD_type( )));
+  EXPECT_TRUE(is_true(type_traits<plain_point>::has_trivial_assignment_operator( )));
+  EXPECT_TRUE(is_true(type_traits<plain_point>::has_trivial_destructor( )));
+
+  EXPECT_FALSE(is_true(type_traits<with_destructor>::has_trivial_destructor( )));
+  EXPECT_FALSE(is_true(type_traits<with_destructor>::is_POD_type( )));
+  EXPECT_TRUE(is_true(type_traits<with_destructor>::has_trivial_assignment_operator( )));
+
+  EXPECT_FALSE(is_true(type_traits<std::string>::has_trivial_copy_constructor( )));
+  EXPECT_FALSE(is_true(type_traits<std::string>::has_trivial_assignment_operator( )));
+  EXPECT_FALSE(is_true(type_traits<std::string>::is_POD_type( )));
+}
+
+} // namespace ministl
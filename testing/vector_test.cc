@@ -1,6 +1,10 @@
 #include "vector.h"
 #include "algorithm.h"
+#include "arena_alloc.h"
+#include "deque.h"
+#include "list.h"
 #include <algorithm>
+#include <sstream>
 #include "gtest/gtest.h"
 
 namespace ministl {
@@ -86,4 +90,276 @@ TEST(VectorTest, insert_erase_test)
   EXPECT_EQ(test_value + 1, vec.back( ));
 }
 
-} // namespace ministl
\ No newline at end of file
+TEST(VectorTest, reallocate_growth_test)
+{
+  // int is relocatable, the storage grows through reallocate
+  ministl::vector<int> vec;
+  for (int i = 0; i < 10000; ++i)
+    vec.push_back(i);
+  EXPECT_EQ(10000, vec.size( ));
+  EXPECT_EQ(16384, vec.capacity( ));
+  for (int i = 0; i < 10000; ++i)
+    EXPECT_EQ(i, vec[i]);
+
+  ministl::vector<int, malloc_alloc> big(4096, 1);
+  big.insert(big.begin( ) + 1, 1, 2);
+  big.insert(big.begin( ), 5000, big[1]);
+  EXPECT_EQ(9097, big.size( ));
+  EXPECT_EQ(2, big[0]);
+  EXPECT_EQ(2, big[5001]);
+  EXPECT_EQ(1, big[5000]);
+  EXPECT_EQ(1, big.back( ));
+}
+
+// counts the copies and moves of its instances
+struct counted {
+  static int copies;
+  static int moves;
+  int value;
+
+  explicit counted(int v = 0) : value(v) { }
+  counted(int a, int b) : value(a + b) { }
+  counted(const counted& x) : value(x.value) { ++copies; }
+  counted(counted&& x) noexcept : value(x.value) { ++moves; }
+  counted& operator=(const counted& x) { value = x.value; ++copies; return *this; }
+  counted& operator=(counted&& x) noexcept { value = x.value; ++moves; return *this; }
+};
+
+int counted::copies = 0;
+int counted::moves = 0;
+
+TEST(VectorTest, move_emplace_test)
+{
+  counted::copies = counted::moves = 0;
+  ministl::vector<counted> vec;
+  for (int i = 0; i < 100; ++i)
+    vec.emplace_back(i, 1);
+  vec.push_back(counted(101));
+  vec.emplace(vec.begin( ), 0);
+  vec.insert(vec.begin( ) + 1, counted(-1));
+  EXPECT_EQ(0, counted::copies);
+  EXPECT_EQ(103, vec.size( ));
+  EXPECT_EQ(0, vec[0].value);
+  EXPECT_EQ(-1, vec[1].value);
+  EXPECT_EQ(1, vec[2].value);
+  EXPECT_EQ(101, vec.back( ).value);
+
+  vec.erase(vec.begin( ));
+  EXPECT_EQ(0, counted::copies);
+  EXPECT_EQ(-1, vec.front( ).value);
+
+  ministl::vector<counted> moved(std::move(vec));
+  EXPECT_TRUE(vec.empty( ));
+  EXPECT_EQ(102, moved.size( ));
+  EXPECT_EQ(0, counted::copies);
+
+  ministl::vector<counted> copied(moved);
+  EXPECT_EQ(102, counted::copies);
+  vec = copied;
+  EXPECT_EQ(204, counted::copies);
+  vec = std::move(moved);
+  EXPECT_EQ(204, counted::copies);
+  EXPECT_TRUE(moved.empty( ));
+  EXPECT_EQ(102, vec.size( ));
+  EXPECT_EQ(101, vec.back( ).value);
+
+  // an element referring to the vector itself
+  ministl::vector<std::string> strs(1, "test");
+  for (int i = 0; i < 10; ++i)
+    strs.push_back(strs[0]);
+  strs.emplace(strs.begin( ), strs.back( ));
+  strs.emplace_back(3, 'a');
+  EXPECT_EQ(13, strs.size( ));
+  EXPECT_TRUE(std::all_of(strs.begin( ), strs.end( ) - 1,
+                          [](const std::string& str) { return str == "test"; }));
+  EXPECT_EQ("aaa", strs.back( ));
+
+  ministl::vector<ministl::vector<int> > nested;
+  for (int i = 0; i < 10; ++i)
+    nested.emplace_back(i, i);
+  EXPECT_EQ(9, nested[9].size( ));
+  EXPECT_EQ(9, nested[9][8]);
+}
+
+TEST(VectorTest, reserve_shrink_to_fit_test)
+{
+  ministl::vector<int> ints;
+  ints.reserve(1000);
+  EXPECT_EQ(1000, ints.capacity( ));
+  for (int i = 0; i < 1000; ++i)
+    ints.push_back(i);
+  EXPECT_EQ(1000, ints.capacity( ));
+  ints.reserve(10);
+  EXPECT_EQ(1000, ints.capacity( ));
+  ints.erase(ints.begin( ) + 100, ints.end( ));
+  ints.shrink_to_fit( );
+  EXPECT_EQ(100, ints.capacity( ));
+  EXPECT_EQ(99, ints.back( ));
+
+  ministl::vector<std::string> strs(10, "test");
+  strs.reserve(100);
+  EXPECT_EQ(100, strs.capacity( ));
+  EXPECT_EQ(10, strs.size( ));
+  strs.shrink_to_fit( );
+  EXPECT_EQ(10, strs.capacity( ));
+  EXPECT_TRUE(std::all_of(strs.begin( ), strs.end( ), [](const std::string& str) { return str == "test"; }));
+  strs.clear( );
+  strs.shrink_to_fit( );
+  EXPECT_EQ(0, strs.capacity( ));
+}
+
+TEST(VectorTest, growth_policy_test)
+{
+  ministl::vector<int, alloc, vector_half_growth> half;
+  for (int i = 0; i < 5; ++i)
+    half.push_back(i);
+  EXPECT_EQ(7, half.capacity( ));
+
+  // the capacity fills the whole size class of the block
+  typedef default_alloc_template<false, 0, geometric_size_classes<4096> > pool;
+  ministl::vector<double, pool, vector_size_class_growth<> > fitted;
+  fitted.push_back(1.0);
+  fitted.push_back(2.0);
+  fitted.push_back(3.0);
+  EXPECT_EQ(pool::good_size(4 * sizeof(double)) / sizeof(double), fitted.capacity( ));
+  for (int i = 0; i < 1000; ++i)
+    fitted.push_back(i);
+  EXPECT_EQ(pool::good_size(fitted.capacity( ) * sizeof(double)),
+            fitted.capacity( ) * sizeof(double));
+}
+
+TEST(VectorTest, range_insert_assign_test)
+{
+  const int values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  ministl::vector<int> from_array(values, values + 10);
+  EXPECT_EQ(10, from_array.size( ));
+  EXPECT_EQ(10, from_array.capacity( ));
+  EXPECT_TRUE(std::equal(values, values + 10, from_array.begin( )));
+
+  ministl::list<int> lst;
+  ministl::deque<int> deq;
+  for (int i = 0; i < 10; ++i) {
+    lst.push_back(i);
+    deq.push_back(i);
+  }
+  ministl::vector<int> from_list(lst.begin( ), lst.end( ));
+  ministl::vector<int> from_deque(deq.begin( ), deq.end( ));
+  EXPECT_EQ(10, from_list.capacity( ));
+  EXPECT_EQ(10, from_deque.capacity( ));
+  EXPECT_TRUE(std::equal(values, values + 10, from_list.begin( )));
+  EXPECT_TRUE(std::equal(values, values + 10, from_deque.begin( )));
+
+  std::istringstream input("0 1 2 3 4 5 6 7 8 9");
+  ministl::vector<int> from_stream((istream_iterator<int>(input)), istream_iterator<int>( ));
+  EXPECT_TRUE(std::equal(values, values + 10, from_stream.begin( )));
+
+  ministl::vector<int> int_pair(5, 7);
+  EXPECT_EQ(5, int_pair.size( ));
+  EXPECT_EQ(7, int_pair[4]);
+
+  // insert into free capacity and with growth
+  ministl::vector<std::string> strs;
+  const std::string words[] = { "a", "b", "c", "d" };
+  strs.reserve(10);
+  strs.insert(strs.end( ), words, words + 4);
+  strs.insert(strs.begin( ) + 1, words, words + 2);
+  strs.insert(strs.begin( ) + 5, words + 3, words + 4);
+  const std::string expected[] = { "a", "a", "b", "b", "c", "d", "d" };
+  EXPECT_EQ(7, strs.size( ));
+  EXPECT_TRUE(std::equal(expected, expected + 7, strs.begin( )));
+  strs.insert(strs.begin( ), expected, expected + 7);
+  EXPECT_EQ(14, strs.size( ));
+  EXPECT_TRUE(std::equal(expected, expected + 7, strs.begin( ) + 7));
+
+  from_array.insert(from_array.begin( ) + 5, lst.begin( ), lst.end( ));
+  EXPECT_EQ(20, from_array.size( ));
+  EXPECT_EQ(9, from_array[14]);
+  EXPECT_EQ(5, from_array[15]);
+
+  // assign shorter, longer and larger than the capacity
+  strs.assign(words, words + 2);
+  EXPECT_EQ(2, strs.size( ));
+  EXPECT_EQ("b", strs.back( ));
+  strs.assign(words, words + 4);
+  EXPECT_TRUE(std::equal(words, words + 4, strs.begin( )));
+  strs.assign(100, "x");
+  EXPECT_EQ(100, strs.size( ));
+  EXPECT_EQ("x", strs[99]);
+  strs.assign(3, "y");
+  EXPECT_EQ(3, strs.size( ));
+
+  std::istringstream more("3 2 1");
+  from_list.assign((istream_iterator<int>(more)), istream_iterator<int>( ));
+  EXPECT_EQ(3, from_list.size( ));
+  EXPECT_EQ(1, from_list.back( ));
+  from_list.assign(4, 2);
+  EXPECT_EQ(4, from_list.size( ));
+  EXPECT_EQ(2, from_list.front( ));
+}
+
+// owns a heap object, the pointer stays valid at any address
+struct relocatable_handle {
+  static int copies;
+  static int destructions;
+  int* value;
+
+  explicit relocatable_handle(int v) : value(new int(v)) { }
+  relocatable_handle(const relocatable_handle& x) : value(new int(*x.value)) { ++copies; }
+  relocatable_handle& operator=(const relocatable_handle& x) { *value = *x.value; ++copies; return *this; }
+  ~relocatable_handle( ) { delete value; ++destructions; }
+};
+
+int relocatable_handle::copies = 0;
+int relocatable_handle::destructions = 0;
+
+template <>
+struct is_trivially_relocatable<relocatable_handle> {
+  typedef true_type type;
+};
+
+TEST(VectorTest, trivially_relocatable_test)
+{
+  EXPECT_TRUE((std::is_same<is_trivially_relocatable<int>::type, true_type>::value));
+  EXPECT_TRUE((std::is_same<is_trivially_relocatable<std::string>::type, false_type>::value));
+
+  relocatable_handle::copies = relocatable_handle::destructions = 0;
+  {
+    ministl::vector<relocatable_handle> handles;
+    for (int i = 0; i < 100; ++i)
+      handles.emplace_back(i);
+    relocatable_handle::copies = relocatable_handle::destructions = 0;
+    handles.reserve(1000);
+    handles.shrink_to_fit( );
+    EXPECT_EQ(0, relocatable_handle::copies);
+    EXPECT_EQ(0, relocatable_handle::destructions);
+    for (int i = 0; i < 100; ++i)
+      EXPECT_EQ(i, *handles[i].value);
+  }
+  EXPECT_EQ(100, relocatable_handle::destructions);
+
+  std::string* from = static_cast<std::string*>(::operator new(3 * sizeof(std::string)));
+  std::string* to = static_cast<std::string*>(::operator new(3 * sizeof(std::string)));
+  const std::string strs[3] = { "a", "b", "c" };
+  ministl::uninitialized_copy(strs, strs + 3, from);
+  EXPECT_EQ(to + 3, uninitialized_relocate(from, from + 3, to));
+  EXPECT_EQ("c", to[2]);
+  destory(to, to + 3);
+  ::operator delete(from);
+  ::operator delete(to);
+}
+
+TEST(VectorTest, stateful_allocator_test)
+{
+  EXPECT_EQ(3 * sizeof(int*), sizeof(ministl::vector<int>));
+
+  monotonic_arena arena;
+  ministl::vector<int, arena_ref> vec((arena_ref(arena)));
+  for (int i = 0; i < 100; ++i)
+    vec.push_back(i);
+  EXPECT_EQ(100, vec.size( ));
+  EXPECT_EQ(99, vec.back( ));
+  EXPECT_TRUE(vec.get_allocator( ) == arena_ref(arena));
+  EXPECT_GE(arena.size( ), 100 * sizeof(int));
+}
+
+} // namespace ministl